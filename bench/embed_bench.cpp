@@ -0,0 +1,94 @@
+// 같은 식을 인자만 바꿔 반복 계산할 때 read + eval과 준비된 식(prepare, eval_prepared)의 1회 소요 시간 비교
+// 컴파일: g++ -o embed_bench ./bench/embed_bench.cpp -std=c++11 -O2
+#define SCHEME_NODE_ARRAY_SIZE 4096
+#define SCHEME_HASH_TABLE_SIZE 1009
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../interpreter.h"
+
+const char* DEFINITION = "(define (score w x) (cond ((< (* w x) 0) 0) ((> (* w x) 1) 1) (else (* w x))))";
+const int REPEAT = 100000;
+
+// @return read + eval 1회 평균 소요 시간(us).
+double run_read_eval(Interpreter& interpreter, double& sum) {
+    std::string output = "";
+    sum = 0.0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEAT; i++) {
+        // host가 인자를 식의 문자열에 넣어 매번 다시 읽음
+        interpreter.read("(score 0.001 " + std::to_string(i % 1000) + ")");
+        if (!interpreter.eval(output)) {
+            std::cerr << output << "\n";
+            return 0.0;
+        }
+        sum += std::stod(output);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / REPEAT;
+}
+
+// @return eval_prepared 1회 평균 소요 시간(us).
+double run_prepared(Interpreter& interpreter, double& sum) {
+    std::string error = "";
+    sum = 0.0;
+
+    const int handle = interpreter.prepare("(score w x)", {"w", "x"}, error);
+    std::vector<SchemeValue> args = {0.001, 0.0};
+    SchemeValue result;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < REPEAT; i++) {
+        args[1] = static_cast<double>(i % 1000);
+        if (!interpreter.eval_prepared(handle, args, result, error)) {
+            std::cerr << error << "\n";
+            return 0.0;
+        }
+        sum += result.get_number();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    interpreter.release_prepared(handle);
+    return std::chrono::duration<double, std::micro>(end - start).count() / REPEAT;
+}
+
+int main(void) {
+    std::cout << "mode      | read+eval (us) | prepared (us) | speedup | result\n"
+              << "----------+----------------+---------------+---------+-------\n";
+
+    for (const bool compiled : {false, true}) {
+        std::unique_ptr<Interpreter> interpreter(new Interpreter());
+        interpreter->init();
+        if (compiled) {
+            interpreter->set_execution_mode(Interpreter::ExecutionMode::CLOSURE_COMPILED);
+        }
+
+        // GC 메시지는 버림
+        std::ostringstream messages;
+        interpreter->set_message_stream(messages);
+
+        std::string output = "";
+        interpreter->read(DEFINITION);
+        interpreter->eval(output);
+
+        double read_eval_sum = 0.0, prepared_sum = 0.0;
+        const double read_eval_us = run_read_eval(*interpreter, read_eval_sum);
+        const double prepared_us = run_prepared(*interpreter, prepared_sum);
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-9s | %14.3f | %13.3f | %6.1fx | %g%s\n",
+                      compiled ? "compiled" : "tree walk", read_eval_us, prepared_us, read_eval_us / prepared_us,
+                      prepared_sum, (read_eval_sum == prepared_sum) ? "" : " (MISMATCH)");
+        std::cout << line;
+    }
+
+    return 0;
+}
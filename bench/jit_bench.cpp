@@ -0,0 +1,79 @@
+// 숫자 재귀 함수의 실행 방식별 소요 시간 비교
+// 컴파일: g++ -o jit_bench ./bench/jit_bench.cpp -std=c++11 -O2
+#define SCHEME_NODE_ARRAY_SIZE 4096
+#define SCHEME_HASH_TABLE_SIZE 1009
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../interpreter.h"
+
+struct bench_case_struct {
+    const char* name;
+    const char* definition;
+    const char* expression;
+    int repeat;
+};
+
+const bench_case_struct BENCH_CASES[] = {
+    {"fib 20",
+     "(define (fib n) (cond ((< n 2) n) (else (+ (fib (- n 1)) (fib (- n 2))))))",
+     "(fib 20)", 5},
+    {"tak 18 12 6",
+     "(define (tak x y z) (cond ((< y x) (tak (tak (- x 1) y z) (tak (- y 1) z x) (tak (- z 1) x y))) (else z)))",
+     "(tak 18 12 6)", 5},
+};
+
+// @return 1회 평균 소요 시간(ms).
+double run_case(const bench_case_struct& bench_case, const bool compiled, const bool jit, std::string& result) {
+    std::unique_ptr<Interpreter> interpreter(new Interpreter());
+    interpreter->init();
+    if (compiled) {
+        interpreter->set_execution_mode(Interpreter::ExecutionMode::CLOSURE_COMPILED);
+    }
+    interpreter->set_jit_enabled(jit);
+
+    // eval()의 출력은 결과 확인용으로만 모음
+    std::ostringstream output;
+    std::streambuf* orig_buf = std::cout.rdbuf(output.rdbuf());
+
+    interpreter->read(bench_case.definition);
+    interpreter->eval();
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < bench_case.repeat; i++) {
+        output.str("");
+        interpreter->read(bench_case.expression);
+        interpreter->eval();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    std::cout.rdbuf(orig_buf);
+    result = output.str().substr(0, output.str().find('\n'));
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / bench_case.repeat;
+}
+
+int main(void) {
+    std::cout << "case          | tree walk (ms) | compiled (ms) | jit (ms) | speedup | result\n"
+              << "--------------+----------------+---------------+----------+---------+-------\n";
+
+    for (const bench_case_struct& bench_case : BENCH_CASES) {
+        std::string tree_result, compiled_result, jit_result;
+        const double tree_ms = run_case(bench_case, false, false, tree_result);
+        const double compiled_ms = run_case(bench_case, true, false, compiled_result);
+        const double jit_ms = run_case(bench_case, false, true, jit_result);
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-13s | %14.3f | %13.3f | %8.3f | %6.1fx | %s%s\n",
+                      bench_case.name, tree_ms, compiled_ms, jit_ms, tree_ms / jit_ms, jit_result.c_str(),
+                      (tree_result == jit_result && tree_result == compiled_result) ? "" : " (MISMATCH)");
+        std::cout << line;
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+// task 여러 개가 channel로 보내는 값을 host가 하나로 합칠 때 값 하나의 평균 소요 시간과 결과 확인
+// 할당하는 cell이 node array보다 훨씬 많으므로 channel에서 기다리는 task가 중단된 채로 GC를 여러 번 거침
+// 컴파일: g++ -o task_bench ./bench/task_bench.cpp -std=c++11 -O2 (Linux 전용)
+#define SCHEME_NODE_ARRAY_SIZE 1024
+#define SCHEME_HASH_TABLE_SIZE 1009
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../interpreter.h"
+
+const int TASKS = 20;  // 한 번에 spawn하는 task 수
+const int ITEMS = 20;  // task 하나가 보내는 값의 수
+const int ROUNDS = 50;
+
+// task k는 (k . i)를 in에 보내면서 보낸 i를 mine에 모아 두고, 끝나면 (length mine)을 done에 보냄
+const char* DEFINITIONS[] = {
+    "(define in (make-channel 4))",
+    "(define done (make-channel 100))",
+    "(define (produce k) (do ((i 0 (+ i 1)) (mine '() (cons i mine))) ((= i 20) (channel-put done (length mine))) (channel-put in (cons k i))))",
+    "(define (spawn-producers k) (cond ((= k 0) 0) (else (begin (spawn (lambda () (produce k))) (spawn-producers (- k 1))))))",
+};
+
+int main(void) {
+    if (!SCHEME_GENERATOR_AVAILABLE) {
+        std::cerr << "tasks are not supported on this platform\n";
+        return 1;
+    }
+
+    std::unique_ptr<Interpreter> interpreter(new Interpreter());
+    interpreter->init();
+
+    // 계산 도중의 GC 메시지 (명령이 중단되면 task도 끝나므로 결과가 맞지 않게 됨)
+    std::ostringstream messages;
+    interpreter->set_message_stream(messages);
+
+    std::string output = "";
+    for (const char* definition : DEFINITIONS) {
+        interpreter->read(definition);
+        if (!interpreter->eval(output)) {
+            std::cerr << output << "\n";
+            return 1;
+        }
+    }
+
+    std::string error = "";
+    const int spawn = interpreter->prepare("(spawn-producers k)", {"k"}, error);
+    const int take = interpreter->prepare("(let ((item (channel-get in))) (+ (* (car item) 100) (cdr item)))", {}, error);
+    const int finish = interpreter->prepare("(channel-get done)", {}, error);
+    SchemeValue result;
+
+    double sum = 0.0, expected_sum = 0.0;
+    int lengths = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; round++) {
+        if (!interpreter->eval_prepared(spawn, {static_cast<double>(TASKS)}, result, error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+
+        for (int i = 0; i < TASKS * ITEMS; i++) {
+            if (!interpreter->eval_prepared(take, {}, result, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            sum += result.get_number();
+        }
+        for (int i = 0; i < TASKS; i++) {
+            if (!interpreter->eval_prepared(finish, {}, result, error)) {
+                std::cerr << error << "\n";
+                return 1;
+            }
+            lengths += static_cast<int>(result.get_number());
+        }
+
+        for (int k = 1; k <= TASKS; k++) {
+            for (int i = 0; i < ITEMS; i++) {
+                expected_sum += k * 100 + i;
+            }
+        }
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const int items = ROUNDS * TASKS * ITEMS;
+    const bool matched = (sum == expected_sum && lengths == items && messages.str().empty());
+    char line[256];
+    std::snprintf(line, sizeof(line), "tasks %d x %d rounds | items %d | %.3f us/item | sum %g%s\n", TASKS, ROUNDS, items,
+                  std::chrono::duration<double, std::micro>(end - start).count() / items, sum, matched ? "" : " (MISMATCH)");
+    std::cout << line;
+
+    return matched ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// 긴 list를 순회할 때의 C++ stack 사용량 비교 (HeapWalker / 이전의 재귀 방식)
+// 컴파일: g++ -o traversal_bench ./bench/traversal_bench.cpp -std=c++11 -O2
+#define SCHEME_NODE_ARRAY_SIZE 2000003
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../node_array.h"
+
+typedef HeapWalker<NodeArray> Walker;
+
+const int LIST_LENGTHS[] = {1000, 10000, 100000, 1000000};
+const int MAX_RECURSIVE_LENGTH = 100000; // 이보다 길면 재귀 방식은 stack overflow
+
+const char* stack_base = nullptr;
+const char* stack_lowest = nullptr;
+
+// 현재 stack 위치를 기록
+__attribute__((noinline)) void probe_stack() {
+    char marker;
+    stack_lowest = std::min<const char*>(stack_lowest, &marker);
+}
+
+long stack_usage() {
+    return static_cast<long>(stack_base - stack_lowest);
+}
+
+// @return length개의 symbol로 이루어진 list의 root node 포인터.
+int make_flat_list(NodeArray& node_array, const int length) {
+    int root_ptr = 0;
+    for (int i = 0; i < length; i++) {
+        const int node_ptr = node_array.alloc();
+        node_array.set_head(node_ptr, -(i % 100 + 1));
+        node_array.set_tail(node_ptr, root_ptr);
+        root_ptr = node_ptr;
+    }
+
+    return root_ptr;
+}
+
+/* 이전의 재귀 방식 (head와 tail 모두 재귀 호출)
+ * README의 기본 컴파일 옵션(최적화 없음)처럼 꼬리 호출을 반복문으로 바꾸지 않게 함
+ */
+#define RECURSIVE_REFERENCE __attribute__((noinline, optimize("no-optimize-sibling-calls")))
+
+RECURSIVE_REFERENCE void mark_recursive(const NodeArray& node_array, std::vector<bool>& marked, const int index) {
+    probe_stack();
+    if (index <= 0 || marked[index]) return;
+
+    if (node_array.get_lchild(index) > 0) mark_recursive(node_array, marked, node_array.get_lchild(index));
+    if (node_array.get_rchild(index) > 0) mark_recursive(node_array, marked, node_array.get_rchild(index));
+    marked[index] = true;
+}
+
+RECURSIVE_REFERENCE bool equal_recursive(const NodeArray& node_array, const int index1, const int index2) {
+    probe_stack();
+    if (index1 > 0 && index2 > 0) {
+        return equal_recursive(node_array, node_array.get_lchild(index1), node_array.get_lchild(index2)) &&
+               equal_recursive(node_array, node_array.get_rchild(index1), node_array.get_rchild(index2));
+    }
+
+    return index1 == index2;
+}
+
+RECURSIVE_REFERENCE void print_recursive(const NodeArray& node_array, const int index, long& count) {
+    probe_stack();
+    if (index <= 0) {
+        count++;
+        return;
+    }
+
+    print_recursive(node_array, node_array.get_lchild(index), count);
+    if (node_array.get_rchild(index) != 0) {
+        print_recursive(node_array, node_array.get_rchild(index), count);
+    }
+}
+
+class CountVisitor {
+    public:
+    long count = 0;
+
+    void begin_list() { probe_stack(); }
+    void atom(const int) { probe_stack(); count++; }
+    void end_list() { probe_stack(); }
+};
+
+struct measure_struct {
+    long stack_bytes = 0;
+    double time_ms = 0.0;
+};
+
+template <typename Run>
+measure_struct measure(Run run) {
+    char base;
+    stack_base = &base;
+    stack_lowest = &base;
+
+    const auto start = std::chrono::steady_clock::now();
+    run();
+    const auto end = std::chrono::steady_clock::now();
+
+    measure_struct result;
+    result.stack_bytes = stack_usage();
+    result.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+int main() {
+    std::printf("%-9s | %-10s | %14s | %10s | %14s | %10s\n",
+                "length", "walk", "walker stack", "walker ms", "recursive stack", "recursive ms");
+    std::printf("%s\n", std::string(84, '-').c_str());
+
+    for (const int length : LIST_LENGTHS) {
+        std::unique_ptr<NodeArray> node_array(new NodeArray());
+        const int list1 = make_flat_list(*node_array, length);
+        const int list2 = make_flat_list(*node_array, length);
+        const Walker walker(*node_array);
+
+        std::vector<bool> marked(NodeArray::NODE_ARRAY_SIZE, false);
+        const measure_struct mark = measure([&]() {
+            walker.for_each_value(list1, [&](const int index) {
+                probe_stack();
+                if (index <= 0 || marked[index]) return false;
+                marked[index] = true;
+                return true;
+            });
+        });
+
+        bool is_equal = false;
+        const measure_struct equal = measure([&]() {
+            is_equal = walker.is_equal(list1, list2, [](const int value1, const int value2) {
+                probe_stack();
+                if (value1 == value2) return Walker::COMPARE_EQUAL;
+                if (value1 > 0 && value2 > 0) return Walker::COMPARE_DESCEND;
+                return Walker::COMPARE_NOT_EQUAL;
+            });
+        });
+
+        CountVisitor visitor;
+        const measure_struct print = measure([&]() { walker.walk_in_order(list1, visitor); });
+
+        measure_struct mark_old, equal_old, print_old;
+        const bool run_recursive = length <= MAX_RECURSIVE_LENGTH;
+        if (run_recursive) {
+            std::vector<bool> old_marked(NodeArray::NODE_ARRAY_SIZE, false);
+            long old_count = 0;
+            mark_old = measure([&]() { mark_recursive(*node_array, old_marked, list1); });
+            equal_old = measure([&]() { equal_recursive(*node_array, list1, list2); });
+            print_old = measure([&]() { print_recursive(*node_array, list1, old_count); });
+        }
+
+        const struct {
+            const char* name;
+            measure_struct walker;
+            measure_struct recursive;
+            bool has_recursive;
+        } rows[] = {
+            {"mark", mark, mark_old, run_recursive},
+            {"equal?", equal, equal_old, run_recursive},
+            {"print", print, print_old, run_recursive},
+        };
+
+        for (const auto& row : rows) {
+            if (row.has_recursive) {
+                std::printf("%-9d | %-10s | %14ld | %10.2f | %14ld | %10.2f\n", length, row.name,
+                            row.walker.stack_bytes, row.walker.time_ms, row.recursive.stack_bytes, row.recursive.time_ms);
+            } else {
+                std::printf("%-9d | %-10s | %14ld | %10.2f | %14s | %10s\n", length, row.name,
+                            row.walker.stack_bytes, row.walker.time_ms, "-", "-");
+            }
+        }
+
+        if (!is_equal || visitor.count != length) {
+            std::printf("MISMATCH: equal=%d, printed atoms=%ld\n", is_equal, visitor.count);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <deque>
+
+#include "heap_object.h"
+
+/* task 사이의 크기가 정해진 channel (make-channel)
+ * buffer가 가득 차면 channel-put이, 비어 있으면 channel-get이 기다린다.
+ * 기다리는 task의 cell은 도착한 순서대로 기록해 두었다가 상대쪽이 값을 넣거나 꺼내면 하나씩 깨운다.
+ */
+class Channel: public HeapObject {
+    private:
+    size_t capacity = 1;
+    std::deque<int> buffer;
+    std::deque<int> waiting_getters; // 값을 기다리는 task의 cell
+    std::deque<int> waiting_putters; // 빈 자리를 기다리는 task의 cell
+
+    // @return 가장 먼저 기다린 task의 cell. (없으면 0)
+    static int pop_waiting(std::deque<int>& waiting) {
+        if (waiting.empty()) {
+            return 0;
+        }
+
+        const int task = waiting.front();
+        waiting.pop_front();
+        return task;
+    }
+
+    public:
+    explicit Channel(const size_t capacity) : capacity(capacity) {}
+
+    std::string type_name() const override {
+        return "channel";
+    }
+
+    void trace(std::vector<int>& values) const override {
+        values.insert(values.end(), buffer.begin(), buffer.end());
+        values.insert(values.end(), waiting_getters.begin(), waiting_getters.end());
+        values.insert(values.end(), waiting_putters.begin(), waiting_putters.end());
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + (buffer.size() + waiting_getters.size() + waiting_putters.size()) * sizeof(int);
+    }
+
+    bool is_empty() const {
+        return buffer.empty();
+    }
+
+    bool is_full() const {
+        return buffer.size() >= capacity;
+    }
+
+    void put(const int value) {
+        buffer.push_back(value);
+    }
+
+    int get() {
+        const int value = buffer.front();
+        buffer.pop_front();
+        return value;
+    }
+
+    void wait_for_value(const int task) {
+        waiting_getters.push_back(task);
+    }
+
+    void wait_for_space(const int task) {
+        waiting_putters.push_back(task);
+    }
+
+    // @return 깨울 task의 cell. (없으면 0)
+    int pop_getter() {
+        return pop_waiting(waiting_getters);
+    }
+
+    int pop_putter() {
+        return pop_waiting(waiting_putters);
+    }
+};
+
+#endif
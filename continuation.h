@@ -0,0 +1,42 @@
+#ifndef CONTINUATION_H
+#define CONTINUATION_H
+
+#include "heap_object.h"
+
+/* one-shot escape continuation (call/1cc)
+ * call/1cc가 계산을 마치기 전에 한 번만 호출할 수 있으며, 호출하면 C++ 예외로 call/1cc까지 바로 빠져나간다.
+ * call/1cc가 끝나면 (정상 종료, 탈출, 오류 모두) 닫히므로 다시 들어가는 continuation은 만들 수 없다.
+ * generator 안에서 만든 continuation은 그 generator가 실행 중일 때만 호출할 수 있다.
+ */
+class Continuation: public HeapObject {
+    private:
+    int owner = 0; // 만든 generator의 cell (0: generator 밖)
+    bool active = true;
+
+    public:
+    explicit Continuation(const int owner) : owner(owner) {}
+
+    std::string type_name() const override {
+        return "continuation";
+    }
+
+    void trace(std::vector<int>&) const override {}
+
+    size_t heap_size() const override {
+        return sizeof(*this);
+    }
+
+    int get_owner() const {
+        return owner;
+    }
+
+    bool is_active() const {
+        return active;
+    }
+
+    void close() {
+        active = false;
+    }
+};
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef ESCAPE_ANALYSIS_H
+#define ESCAPE_ANALYSIS_H
+
+#include <string>
+#include <vector>
+
+#include "node_array.h"
+#include "hash_table.h"
+
+/* lambda 본문의 escape 분석
+ * cons가 만든 cell이 그 호출이 끝난 뒤에도 쓰일 수 있는지를 parse tree만 보고 판단한다.
+ * 변수는 동적으로 묶이므로 (호출된 함수가 이름으로 읽을 수 있음) 다음 위치의 cons만 escape하지 않는 것으로 본다.
+ *  - car, cdr, null?, eq? 등 값을 살펴보기만 하는 기본 함수의 인자
+ *  - cond의 조건, begin과 let 본문의 마지막이 아닌 식 (결과를 버림)
+ *  - let, let*의 초기값 중 그 변수가 범위 안에서 위의 기본 함수의 인자로만 쓰이고,
+ *    범위 안에 산술, 비교, list 기본 함수 외의 호출이 없는 것
+ * cons의 인자, 함수의 결과, 사용자 함수의 인자 등은 모두 escape한다.
+ * lambda, delay, cons-stream 안의 식은 다른 때에 계산되므로 분석하지 않는다.
+ */
+class EscapeAnalyzer {
+    private:
+    enum Context {
+        ESCAPE, // 값이 남을 수 있음
+        LOCAL   // 값을 살펴보기만 하고 버림
+    };
+
+    const NodeArray& node_array;
+    const HashTable& hash_table;
+    std::vector<int> sites;
+
+    bool is_list(const int expr) const {
+        return expr > 0 && !node_array.is_object(expr);
+    }
+
+    // @return list 식의 첫 symbol의 이름. (symbol이 아니면 "")
+    std::string keyword(const int expr) const {
+        if (!is_list(expr) || node_array.get_lchild(expr) >= 0) {
+            return "";
+        }
+        return hash_table.get_value(node_array.get_lchild(expr));
+    }
+
+    // 인자를 살펴보기만 하는 기본 함수
+    static bool is_inspector(const std::string& name) {
+        return name == "car" || name == "cdr" || name == "null?" || name == "number?" ||
+               name == "symbol?" || name == "eq?" || name == "equal?";
+    }
+
+    // 사용자 함수를 호출하지 않는 기본 함수와 문법
+    static bool is_primitive(const std::string& name) {
+        return is_inspector(name) || name == "+" || name == "-" || name == "*" || name == "/" || name == "%" ||
+               name == "=" || name == "<" || name == ">" || name == "cons" || name == "begin";
+    }
+
+    // @return (let name ...) 형태인지의 여부.
+    bool is_named_let(const int expr) const {
+        const int argument = node_array.get_rchild(expr);
+        return argument > 0 && node_array.get_lchild(argument) < 0;
+    }
+
+    // @return var가 expr 안에서 살펴보는 기본 함수의 인자로만 쓰이고 다른 함수 호출이 없는지의 여부.
+    bool is_local_only(const int var, const int expr) const {
+        if (expr == var) {
+            return false; // 값 그대로 쓰임
+        } else if (!is_list(expr)) {
+            return true;
+        }
+
+        const std::string name = keyword(expr);
+        if (name == "quote") {
+            return true;
+        } else if (is_inspector(name)) {
+            for (int argument = node_array.get_rchild(expr); argument != 0; argument = node_array.get_rchild(argument)) {
+                const int arg = node_array.get_lchild(argument);
+                if (arg != var && !is_local_only(var, arg)) return false;
+            }
+            return true;
+        } else if (name == "cond") {
+            for (int clause = node_array.get_rchild(expr); clause != 0; clause = node_array.get_rchild(clause)) {
+                for (int item = node_array.get_lchild(clause); is_list(item); item = node_array.get_rchild(item)) {
+                    if (!is_local_only(var, node_array.get_lchild(item))) return false;
+                }
+            }
+            return true;
+        } else if ((name == "let" || name == "let*") && !is_named_let(expr)) {
+            const int argument = node_array.get_rchild(expr);
+            if (!is_list(argument)) return false;
+
+            for (int clause = node_array.get_lchild(argument); clause != 0; clause = node_array.get_rchild(clause)) {
+                const int binding = node_array.get_lchild(clause);
+                if (!is_list(binding) || node_array.get_lchild(binding) == var) return false; // 같은 이름을 다시 묶음
+                if (!is_local_only(var, node_array.get_lchild(node_array.get_rchild(binding)))) return false;
+            }
+            for (int body = node_array.get_rchild(argument); body != 0; body = node_array.get_rchild(body)) {
+                if (!is_local_only(var, node_array.get_lchild(body))) return false;
+            }
+            return true;
+        } else if (is_primitive(name)) {
+            for (int argument = node_array.get_rchild(expr); argument != 0; argument = node_array.get_rchild(argument)) {
+                if (!is_local_only(var, node_array.get_lchild(argument))) return false;
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    // @param body: 식의 list. 마지막 식만 context로, 나머지는 LOCAL로 분석
+    void visit_body(const int body, const Context context) {
+        for (int expr = body; expr != 0; expr = node_array.get_rchild(expr)) {
+            visit(node_array.get_lchild(expr), node_array.get_rchild(expr) == 0 ? context : LOCAL);
+        }
+    }
+
+    void visit_args(const int expr, const Context context) {
+        for (int argument = node_array.get_rchild(expr); argument != 0; argument = node_array.get_rchild(argument)) {
+            visit(node_array.get_lchild(argument), context);
+        }
+    }
+
+    void visit(const int expr, const Context context) {
+        if (!is_list(expr)) {
+            return;
+        }
+
+        const int head = node_array.get_lchild(expr);
+        if (head >= 0) {
+            // ((lambda ...) arg ...)
+            visit(head, ESCAPE);
+            visit_args(expr, ESCAPE);
+            return;
+        }
+
+        const std::string name = keyword(expr);
+        const int argument = node_array.get_rchild(expr);
+        if (name == "quote" || name == "lambda" || name == "delay" || name == HashTable::symbol_name("cons-stream") ||
+            name == HashTable::symbol_name("define-syntax")) {
+            return;
+
+        } else if (name == "cons") {
+            if (context == LOCAL) {
+                sites.push_back(expr);
+            }
+            visit_args(expr, ESCAPE);
+
+        } else if (is_inspector(name)) {
+            visit_args(expr, LOCAL);
+
+        } else if (name == "cond") {
+            // (test expr) 절의 test는 #t와 비교만 함
+            for (int clause = argument; clause != 0; clause = node_array.get_rchild(clause)) {
+                const int items = node_array.get_lchild(clause);
+                if (!is_list(items)) continue;
+
+                visit(node_array.get_lchild(items), LOCAL);
+                visit_body(node_array.get_rchild(items), context);
+            }
+
+        } else if (name == "begin") {
+            visit_body(argument, context);
+
+        } else if ((name == "let" || name == "let*") && is_list(argument) && !is_named_let(expr)) {
+            for (int clause = node_array.get_lchild(argument); clause != 0; clause = node_array.get_rchild(clause)) {
+                const int binding = node_array.get_lchild(clause);
+                if (!is_list(binding) || node_array.get_rchild(binding) == 0) continue;
+
+                // 변수가 쓰이는 범위: 본문 (let*는 뒤의 초기값 포함)
+                const int var = node_array.get_lchild(binding);
+                bool is_local = true;
+                if (name == "let*") {
+                    for (int next = node_array.get_rchild(clause); next != 0 && is_local; next = node_array.get_rchild(next)) {
+                        is_local = is_local_only(var, node_array.get_lchild(next));
+                    }
+                }
+                for (int body = node_array.get_rchild(argument); body != 0 && is_local; body = node_array.get_rchild(body)) {
+                    is_local = is_local_only(var, node_array.get_lchild(body));
+                }
+
+                visit(node_array.get_lchild(node_array.get_rchild(binding)), is_local ? LOCAL : ESCAPE);
+            }
+            visit_body(node_array.get_rchild(argument), context);
+
+        } else if (name == "let" && is_list(argument)) {
+            // named let: 본문이 loop 함수의 본문이 될 수 있음
+            const int bindings = node_array.get_rchild(argument);
+            if (!is_list(bindings)) return;
+            for (int clause = node_array.get_lchild(bindings); is_list(clause); clause = node_array.get_rchild(clause)) {
+                const int binding = node_array.get_lchild(clause);
+                if (is_list(binding)) visit_args(binding, ESCAPE);
+            }
+            visit_body(node_array.get_rchild(bindings), ESCAPE);
+
+        } else if (name == "do" && is_list(argument)) {
+            // (do ((var init step) ...) (test expr ...) body ...)
+            for (int clause = node_array.get_lchild(argument); is_list(clause); clause = node_array.get_rchild(clause)) {
+                const int spec = node_array.get_lchild(clause);
+                if (is_list(spec)) visit_args(spec, ESCAPE);
+            }
+
+            const int exit_clause = node_array.get_lchild(node_array.get_rchild(argument));
+            if (is_list(exit_clause)) {
+                visit(node_array.get_lchild(exit_clause), LOCAL);
+                visit_args(exit_clause, ESCAPE);
+            }
+            if (is_list(node_array.get_rchild(argument))) {
+                visit_body(node_array.get_rchild(node_array.get_rchild(argument)), LOCAL);
+            }
+
+        } else {
+            // 사용자 함수, define 등
+            visit_args(expr, ESCAPE);
+        }
+    }
+
+    public:
+    EscapeAnalyzer(const NodeArray& node_array, const HashTable& hash_table)
+        : node_array(node_array), hash_table(hash_table) {}
+
+    // @param lambda_ptr: (lambda (param ...) body)의 node 포인터.
+    // @return 호출이 끝나면 버려지는 cell을 만드는 cons 식의 node 포인터.
+    std::vector<int> analyze(const int lambda_ptr) {
+        sites.clear();
+        visit(node_array.get_lchild(node_array.get_rchild(node_array.get_rchild(lambda_ptr))), ESCAPE);
+        return sites;
+    }
+};
+
+#endif
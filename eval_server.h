@@ -0,0 +1,365 @@
+#ifndef EVAL_SERVER_H
+#define EVAL_SERVER_H
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#define SCHEME_SOCKET_AVAILABLE 1
+#else
+#define SCHEME_SOCKET_AVAILABLE 0
+#endif
+
+#include "interpreter.h"
+
+/* 평가 server
+ * prelude를 정의한 interpreter 하나를 계속 사용하며 한 줄에 하나씩 JSON 요청을 받는다.
+ *  요청: {"id": 1, "expr": "(+ 1 2)"}, {"id": 2, "op": "reset"}
+ *  응답: {"id":1,"ok":true,"result":"3"}, {"id":1,"ok":false,"error":"SchemeError: ..."}
+ * 요청은 받은 순서대로 처리하므로 응답을 기다리지 않고 여러 요청을 보내도 (pipelining) 응답 순서가 같다.
+ * session 격리: prelude를 읽은 직후의 전역 binding을 저장해 두고
+ *  - stdin: "reset" 요청을 받을 때 복원
+ *  - Unix socket: 연결이 끝날 때마다 복원
+ */
+class EvalServer {
+    private:
+    struct request_struct {
+        std::string id = "null"; // 응답에 그대로 돌려줄 JSON 값
+        std::string op = "eval";
+        std::string expr = "";
+    };
+
+    Interpreter& interpreter;
+
+    static void skip_space(const std::string& line, size_t& pos) {
+        while (pos < line.size() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == '\r')) {
+            pos++;
+        }
+    }
+
+    // @return pos에서 시작하는 JSON 문자열을 해석한 값.
+    static std::string parse_string(const std::string& line, size_t& pos) {
+        if (pos >= line.size() || line[pos] != '"') {
+            throw std::invalid_argument("expected string");
+        }
+        pos++;
+
+        std::string value = "";
+        while (pos < line.size() && line[pos] != '"') {
+            char c = line[pos++];
+            if (c == '\\') {
+                if (pos >= line.size()) break;
+
+                c = line[pos++];
+                switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                case 'b': c = '\b'; break;
+                case 'f': c = '\f'; break;
+                case 'u': // ASCII 범위만 지원
+                    if (pos + 4 > line.size()) throw std::invalid_argument("bad escape");
+                    c = static_cast<char>(std::stoi(line.substr(pos, 4), nullptr, 16));
+                    pos += 4;
+                    break;
+                default: break; // \" \\ \/
+                }
+            }
+            value += c;
+        }
+
+        if (pos >= line.size()) {
+            throw std::invalid_argument("unterminated string");
+        }
+        pos++;
+        return value;
+    }
+
+    // @return pos에서 시작하는 JSON 값의 원문. (문자열, 숫자, true/false/null, 객체, 배열)
+    static std::string parse_raw_value(const std::string& line, size_t& pos) {
+        const size_t start = pos;
+        if (pos < line.size() && line[pos] == '"') {
+            parse_string(line, pos);
+            return line.substr(start, pos - start);
+        }
+
+        int depth = 0;
+        while (pos < line.size()) {
+            const char c = line[pos];
+            if (c == '"') {
+                parse_string(line, pos);
+                continue;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if (c == '}' || c == ']') {
+                if (depth == 0) break;
+                depth--;
+            } else if (c == ',' && depth == 0) {
+                break;
+            }
+            pos++;
+        }
+
+        std::string value = line.substr(start, pos - start);
+        value.erase(value.find_last_not_of(" \t\r") + 1);
+        if (value.empty()) {
+            throw std::invalid_argument("expected value");
+        }
+        return value;
+    }
+
+    static request_struct parse_request(const std::string& line) {
+        request_struct request;
+        size_t pos = 0;
+
+        skip_space(line, pos);
+        if (pos >= line.size() || line[pos] != '{') {
+            throw std::invalid_argument("expected object");
+        }
+        pos++;
+
+        skip_space(line, pos);
+        while (pos < line.size() && line[pos] != '}') {
+            const std::string key = parse_string(line, pos);
+            skip_space(line, pos);
+            if (pos >= line.size() || line[pos] != ':') {
+                throw std::invalid_argument("expected ':'");
+            }
+            pos++;
+            skip_space(line, pos);
+
+            if (key == "id") {
+                request.id = parse_raw_value(line, pos);
+            } else if (key == "op") {
+                request.op = parse_string(line, pos);
+            } else if (key == "expr") {
+                request.expr = parse_string(line, pos);
+            } else {
+                parse_raw_value(line, pos);
+            }
+
+            skip_space(line, pos);
+            if (pos < line.size() && line[pos] == ',') {
+                pos++;
+                skip_space(line, pos);
+            }
+        }
+
+        if (pos >= line.size()) {
+            throw std::invalid_argument("expected '}'");
+        }
+        return request;
+    }
+
+    static std::string quote_string(const std::string& value) {
+        std::string quoted = "\"";
+        for (const char c : value) {
+            switch (c) {
+            case '"':  quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\t': quoted += "\\t"; break;
+            case '\r': quoted += "\\r"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char escaped[8];
+                    std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                    quoted += escaped;
+                } else {
+                    quoted += c;
+                }
+            }
+        }
+
+        return quoted + "\"";
+    }
+
+    static std::string make_response(const std::string& id, const bool ok, const std::string& text) {
+        return "{\"id\":" + id + ",\"ok\":" + (ok ? "true" : "false") +
+               (ok ? ",\"result\":" : ",\"error\":") + quote_string(text) + "}";
+    }
+
+    // @param output: 계산 결과 또는 오류 메시지를 저장할 곳.
+    // @return 오류 없이 계산했는지의 여부.
+    bool eval_expression(const std::string& expr, std::string& output) {
+        if (is_blank(expr)) {
+            output = "SchemeError: empty expression";
+            return false;
+        }
+
+        try {
+            if (!interpreter.read(expr)) {
+                interpreter.reset_reader();
+                output = "SchemeError: incomplete expression";
+                return false;
+            }
+
+            const bool ok = interpreter.eval(output);
+            output.erase(output.find_last_not_of(" \n") + 1);
+            return ok;
+        } catch (const std::exception& e) {
+            interpreter.reset_reader();
+            output = std::string("InternalError: ") + e.what();
+            return false;
+        }
+    }
+
+    // @return 요청 한 줄에 대한 응답 한 줄.
+    std::string handle_line(const std::string& line) {
+        request_struct request;
+        try {
+            request = parse_request(line);
+        } catch (const std::exception& e) {
+            return make_response("null", false, std::string("BadRequest: ") + e.what());
+        }
+
+        if (request.op == "reset") {
+            interpreter.restore_bindings();
+            return make_response(request.id, true, "reset");
+        } else if (request.op != "eval") {
+            return make_response(request.id, false, "BadRequest: unknown op '" + request.op + "'");
+        }
+
+        std::string output = "";
+        const bool ok = eval_expression(request.expr, output);
+        return make_response(request.id, ok, output);
+    }
+
+    static bool is_blank(const std::string& line) {
+        return line.find_first_not_of(" \t\r\n") == std::string::npos;
+    }
+
+    public:
+    explicit EvalServer(Interpreter& interpreter) : interpreter(interpreter) {
+        // stdout에는 응답만 출력
+        interpreter.set_message_stream(std::cerr);
+        interpreter.set_output_stream(std::cerr);
+    }
+
+    // @param path: 한 줄에 하나씩 명령어가 들어 있는 파일. (';'로 시작하는 줄은 주석)
+    // @return 파일을 열고 모든 명령어를 오류 없이 계산했는지의 여부.
+    static bool load_file(Interpreter& interpreter, const std::string& path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Cannot open file: " << path << "\n";
+            return false;
+        }
+
+        bool ok = true;
+        std::string line = "";
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == ';' || line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            if (!interpreter.read(line)) continue;
+
+            std::string output = "";
+            if (!interpreter.eval(output)) {
+                std::cerr << path << ": " << output;
+                ok = false;
+            }
+        }
+
+        interpreter.reset_reader();
+        return ok;
+    }
+
+    // stdin/stdout JSON-lines protocol
+    void run(std::istream& input, std::ostream& output) {
+        interpreter.save_bindings();
+
+        std::string line = "";
+        while (std::getline(input, line)) {
+            if (is_blank(line)) continue;
+            output << handle_line(line) << "\n";
+            output.flush();
+        }
+    }
+
+    // @param path: Unix domain socket 경로.
+    // @return socket을 열 수 있었는지의 여부.
+    bool run_socket(const std::string& path) {
+#if SCHEME_SOCKET_AVAILABLE
+        const int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (server_fd < 0) {
+            std::perror("socket");
+            return false;
+        }
+
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Socket path is too long: " << path << "\n";
+            close(server_fd);
+            return false;
+        }
+        path.copy(address.sun_path, path.size());
+        unlink(path.c_str());
+
+        if (bind(server_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(server_fd, 16) < 0) {
+            std::perror("bind");
+            close(server_fd);
+            return false;
+        }
+
+        interpreter.save_bindings();
+
+        // 연결 하나가 session 하나: 연결이 끝나면 binding을 복원
+        while (true) {
+            const int client_fd = accept(server_fd, nullptr, nullptr);
+            if (client_fd < 0) continue;
+
+            serve_client(client_fd);
+            close(client_fd);
+            interpreter.restore_bindings();
+        }
+#else
+        std::cerr << "Unix domain sockets are not available on this platform: " << path << "\n";
+        return false;
+#endif
+    }
+
+    private:
+#if SCHEME_SOCKET_AVAILABLE
+    void serve_client(const int client_fd) {
+        std::string buffer = "";
+        char chunk[4096];
+
+        while (true) {
+            const ssize_t size = ::read(client_fd, chunk, sizeof(chunk));
+            if (size <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(size));
+
+            // 받은 요청을 모두 처리한 뒤 응답을 한 번에 보냄
+            std::string responses = "";
+            size_t line_end = 0;
+            while ((line_end = buffer.find('\n')) != std::string::npos) {
+                const std::string line = buffer.substr(0, line_end);
+                buffer.erase(0, line_end + 1);
+                if (is_blank(line)) continue;
+                responses += handle_line(line) + "\n";
+            }
+
+            if (!write_all(client_fd, responses)) break;
+        }
+    }
+
+    static bool write_all(const int fd, const std::string& data) {
+        size_t written = 0;
+        while (written < data.size()) {
+            // 연결이 끊긴 client에 보내도 SIGPIPE로 종료되지 않도록 send 사용
+            const ssize_t size = send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+            if (size <= 0) return false;
+            written += static_cast<size_t>(size);
+        }
+
+        return true;
+    }
+#endif
+};
+
+#endif
@@ -0,0 +1,329 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "heap_object.h"
+#include "port.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#define SCHEME_GENERATOR_AVAILABLE 1
+#else
+#define SCHEME_GENERATOR_AVAILABLE 0
+#endif
+
+// generator 하나의 C++ stack 크기 (byte). 주소 공간만 예약하고 실제 메모리는 사용한 만큼만 할당됨
+#ifndef SCHEME_GENERATOR_STACK_SIZE
+#define SCHEME_GENERATOR_STACK_SIZE (64 << 20)
+#endif
+
+/* 따로 할당한 C++ stack에서 실행하는 coroutine (Linux 전용: ucontext)
+ * resume()은 body를 중단된 곳부터 이어서 실행하고, body 안에서 yield()를 호출하면 resume()한 곳으로 돌아간다.
+ * body에서 빠져나온 예외는 저장해 두었다가 resume()한 쪽에서 다시 던진다.
+ * kill()은 중단된 body의 yield()에서 Killed를 던져 stack을 풀어 (소멸자 실행) 끝낸다.
+ * 중단된 동안에는 stack에서 사용 중인 부분과 저장된 register를 for_each_saved_range()로 읽을 수 있다.
+ * stack의 맨 아래 page는 접근할 수 없게 두어, 넘치면 다른 메모리를 덮어쓰지 않고 바로 중단된다.
+ */
+class Coroutine {
+    public:
+    typedef std::function<void()> Body;
+
+    struct Killed {};
+
+    private:
+    enum State {
+        READY,     // 아직 실행하지 않음
+        RUNNING,
+        SUSPENDED, // yield()로 중단됨
+        DONE
+    };
+
+    Body body;
+    State state = READY;
+    bool killing = false;
+    std::exception_ptr error;
+
+#if SCHEME_GENERATOR_AVAILABLE
+    char* stack = nullptr; // guard page 포함
+    size_t guard_size = 0;
+    ucontext_t context;
+    ucontext_t caller;
+    uintptr_t suspended_top = 0; // 중단된 곳의 stack 주소 (여기부터 stack의 끝까지 사용 중)
+
+    // @return 호출한 함수의 frame보다 아래에 있는 stack 주소.
+    __attribute__((noinline)) static uintptr_t stack_address() {
+        volatile char marker = 0;
+        return reinterpret_cast<uintptr_t>(&marker);
+    }
+
+    void allocate_stack() {
+        guard_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        void* memory = mmap(nullptr, guard_size + SCHEME_GENERATOR_STACK_SIZE, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::length_error("Cannot allocate a generator stack: " + std::to_string(SCHEME_GENERATOR_STACK_SIZE));
+        }
+        stack = static_cast<char*>(memory);
+        mprotect(stack, guard_size, PROT_NONE);
+    }
+
+    void free_stack() {
+        if (stack != nullptr) {
+            munmap(stack, guard_size + SCHEME_GENERATOR_STACK_SIZE);
+            stack = nullptr;
+        }
+    }
+
+    // makecontext()는 int 인자만 넘기므로 this를 둘로 나누어 받음
+    static void entry(const unsigned int high, const unsigned int low) {
+        Coroutine* coroutine = reinterpret_cast<Coroutine*>((static_cast<uintptr_t>(high) << 32) | low);
+        try {
+            coroutine->body();
+        } catch (const Killed&) {
+        } catch (...) {
+            coroutine->error = std::current_exception();
+        }
+        coroutine->state = DONE; // 반환하면 uc_link(caller)로 돌아감
+    }
+#endif
+
+    public:
+    explicit Coroutine(const Body& body) : body(body) {}
+    Coroutine(const Coroutine&) = delete;
+    Coroutine& operator=(const Coroutine&) = delete;
+
+    ~Coroutine() {
+#if SCHEME_GENERATOR_AVAILABLE
+        free_stack(); // 중단된 채로 해제되면 stack의 소멸자는 실행되지 않음 (kill()로 먼저 끝내야 함)
+#endif
+    }
+
+    bool is_running() const {
+        return state == RUNNING;
+    }
+
+    bool is_suspended() const {
+        return state == SUSPENDED;
+    }
+
+    bool is_done() const {
+        return state == DONE;
+    }
+
+    // @return body가 끝났는지의 여부. body에서 빠져나온 예외는 다시 던짐
+    bool resume() {
+#if SCHEME_GENERATOR_AVAILABLE
+        if (state == READY) {
+            allocate_stack();
+            getcontext(&context);
+            context.uc_stack.ss_sp = stack + guard_size;
+            context.uc_stack.ss_size = SCHEME_GENERATOR_STACK_SIZE;
+            context.uc_link = &caller;
+
+            const uintptr_t self = reinterpret_cast<uintptr_t>(this);
+            makecontext(&context, reinterpret_cast<void (*)()>(&Coroutine::entry), 2,
+                        static_cast<unsigned int>(self >> 32), static_cast<unsigned int>(self));
+        }
+        if (state == READY || state == SUSPENDED) {
+            state = RUNNING;
+            swapcontext(&caller, &context);
+        }
+        if (state == DONE) {
+            free_stack();
+        }
+#else
+        state = DONE;
+#endif
+
+        if (error) {
+            std::exception_ptr thrown = error;
+            error = nullptr;
+            std::rethrow_exception(thrown);
+        }
+        return state == DONE;
+    }
+
+    // body 안에서만 호출.
+    // @return 실행 중인 body가 더 사용할 수 있는 stack의 크기. (byte)
+    size_t stack_left() const {
+#if SCHEME_GENERATOR_AVAILABLE
+        const char marker = 0;
+        const uintptr_t top = reinterpret_cast<uintptr_t>(&marker);
+        const uintptr_t bottom = reinterpret_cast<uintptr_t>(stack) + guard_size;
+        return (top > bottom) ? static_cast<size_t>(top - bottom) : 0;
+#else
+        return 0;
+#endif
+    }
+
+    // body 안에서만 호출. kill()로 다시 시작되면 Killed를 던짐
+    void yield() {
+#if SCHEME_GENERATOR_AVAILABLE
+        suspended_top = stack_address();
+        state = SUSPENDED;
+        swapcontext(&context, &caller);
+        state = RUNNING;
+#endif
+        if (killing) {
+            throw Killed();
+        }
+    }
+
+    // 중단된 동안에만 호출.
+    // @param visit: (begin, end)로 호출. 사용 중인 stack과 저장된 register 영역을 차례로 넘김
+    template <typename Visit>
+    void for_each_saved_range(Visit visit) const {
+#if SCHEME_GENERATOR_AVAILABLE
+        if (state != SUSPENDED) {
+            return;
+        }
+
+        const char* bottom = stack + guard_size;
+        const char* top = reinterpret_cast<const char*>(suspended_top);
+        const char* end = bottom + SCHEME_GENERATOR_STACK_SIZE;
+        visit((top > bottom && top < end) ? top : bottom, end);
+        visit(reinterpret_cast<const char*>(&context), reinterpret_cast<const char*>(&context + 1));
+#else
+        (void)visit;
+#endif
+    }
+
+    void kill() {
+        if (state == SUSPENDED) {
+            killing = true;
+            resume();
+        }
+        state = DONE;
+    }
+};
+
+/* generator (make-generator), task (spawn)
+ * 인자가 없는 procedure를 Coroutine으로 실행하며, generator는 호출할 때마다 다음 yield까지 계산한다.
+ * task는 직접 호출할 수 없고 interpreter의 scheduler가 (yield)나 channel에서 기다리는 곳마다 번갈아 실행한다.
+ * 변수는 hash table에 직접 묶이므로 generator 안에서 묶은 변수는 bindings에 따로 기록해 두고,
+ * interpreter가 generator에 들어가고 나올 때마다 hash table의 값과 맞바꾼다.
+ * 중단된 동안에는 C++ stack에 남은 인자, 계산 중인 값도 trace()로 보고하여 GC가 회수하지 않게 한다.
+ *  - stack_values: 중단된 stack과 register에서 찾은 값. (GC 직전에 record_stack_values()로 갱신, 보수적으로 찾음)
+ *  - value_vectors: map, let 등이 계산한 값을 모아 두는 vector. (heap에 있어 stack에서 찾을 수 없으므로 계산하는 동안 등록)
+ */
+class Generator: public HeapObject {
+    public:
+    typedef std::vector<std::pair<int, int>> Bindings; // (symbol의 hash 값, 값)
+    typedef std::vector<const std::vector<int>*> ValueVectors;
+
+    private:
+    int procedure = 0;
+    int transfer = 0; // 주고받는 값 (yield한 값, 다시 시작할 때 넘긴 값)
+    bool task = false;
+    bool blocked = false; // channel에서 기다리는 task
+    bool aborted = false;
+    std::vector<int> stack_values;
+
+    public:
+    Coroutine coroutine;
+    Bindings bindings;  // 실행 중: 묶기 전의 값, 중단됨: generator가 묶은 값
+    OutputPort* output_port = nullptr;
+    int depth_left = 0;
+    ValueVectors value_vectors;
+
+    Generator(const int procedure, const Coroutine::Body& body, OutputPort* output_port, const int depth_left, const bool task)
+        : procedure(procedure), task(task), coroutine(body), output_port(output_port), depth_left(depth_left) {}
+
+    std::string type_name() const override {
+        return task ? "task" : "generator";
+    }
+
+    void trace(std::vector<int>& values) const override {
+        values.push_back(procedure);
+        values.push_back(transfer);
+        for (const std::pair<int, int>& binding : bindings) {
+            values.push_back(binding.first);
+            values.push_back(binding.second);
+        }
+        if (coroutine.is_suspended()) {
+            values.insert(values.end(), stack_values.begin(), stack_values.end());
+            for (const std::vector<int>* vector : value_vectors) {
+                values.insert(values.end(), vector->begin(), vector->end());
+            }
+        }
+    }
+
+    // (stack은 사용한 page만 할당되므로 포함하지 않음)
+    size_t heap_size() const override {
+        return sizeof(*this) + bindings.capacity() * sizeof(std::pair<int, int>) + stack_values.capacity() * sizeof(int);
+    }
+
+    /* 중단된 stack과 register에서 값일 수 있는 word를 모두 stack_values에 기록
+     * int 크기로 정렬된 word마다 is_value()로 확인하고, 포인터 크기로 정렬된 word는 heap object의 주소인지 object_cell()로 확인한다.
+     * (map 등이 값을 꺼내 쓰는 heap object는 cell이 아닌 포인터로만 stack에 남을 수 있음)
+     * @param is_value: word가 살아 있는 cell이나 symbol인지의 여부.
+     * @param object_cell: 주소가 heap object이면 그 cell, 아니면 0.
+     */
+    template <typename IsValue, typename ObjectCell>
+    void record_stack_values(IsValue is_value, ObjectCell object_cell) {
+        stack_values.clear();
+        coroutine.for_each_saved_range([&](const char* begin, const char* end) {
+            const uintptr_t first = reinterpret_cast<uintptr_t>(begin);
+            for (const char* word = begin + (-first & (sizeof(int) - 1)); word + sizeof(int) <= end; word += sizeof(int)) {
+                int value = 0;
+                std::memcpy(&value, word, sizeof(int));
+                if (is_value(value)) {
+                    stack_values.push_back(value);
+                }
+            }
+            for (const char* word = begin + (-first & (sizeof(uintptr_t) - 1)); word + sizeof(uintptr_t) <= end; word += sizeof(uintptr_t)) {
+                uintptr_t address = 0;
+                std::memcpy(&address, word, sizeof(uintptr_t));
+                const int cell = object_cell(address);
+                if (cell > 0) {
+                    stack_values.push_back(cell);
+                }
+            }
+        });
+    }
+
+    int get_procedure() const {
+        return procedure;
+    }
+
+    int get_transfer() const {
+        return transfer;
+    }
+
+    void set_transfer(const int value) {
+        transfer = value;
+    }
+
+    bool is_task() const {
+        return task;
+    }
+
+    bool is_blocked() const {
+        return blocked;
+    }
+
+    void set_blocked(const bool new_blocked) {
+        blocked = new_blocked;
+    }
+
+    bool is_aborted() const {
+        return aborted;
+    }
+
+    // 계산 도중 명령이 중단되었거나, 중단된 채로 init()을 만나 끝남 (C++ stack에 남은 node 포인터를 믿을 수 없음)
+    void abort() {
+        aborted = true;
+    }
+};
+
+#endif
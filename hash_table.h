@@ -1,65 +1,116 @@
 #ifndef HASH_TABLE_H
 #define HASH_TABLE_H
 
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
+
+#include "numeric.h"
+#include "tracer.h"
+
+// 크기 변경: -DSCHEME_HASH_TABLE_SIZE=1009
+#ifndef SCHEME_HASH_TABLE_SIZE
+#define SCHEME_HASH_TABLE_SIZE 101
+#endif
 
 struct hash_table_struct {
     std::string symbol = "";
     int link_of_value = 0;
+
+    // 숫자 symbol: symbol을 추가할 때 한 번만 판별
+    bool is_number = false;
+    bool is_canonical = false; // Numeric::format()이 만드는 형태인지의 여부
+    double number = 0.0;
+
+    bool is_released = false; // GC가 지운 symbol의 자리 (탐색은 계속 지나감)
+    unsigned long long serial = 0; // 추가된 순서 (get_serial()과 비교해 어떤 시점 뒤에 추가되었는지 확인)
 };
 
 class HashTable {
     public:
-    static const int HASH_TABLE_SIZE = 101;
+    static const int HASH_TABLE_SIZE = SCHEME_HASH_TABLE_SIZE;
     static const int MAX_SYMBOL_SIZE = 10;
 
     private:
     hash_table_struct hash_table[HASH_TABLE_SIZE];
 
+    int symbol_count = 0;
+    unsigned long long last_serial = 0; // 마지막으로 추가한 symbol의 serial (clear()해도 되돌리지 않음)
     int max_nonzero_index = 0;
     int max_length_of_symbol = 0;
     int max_length_of_link_ptr = 0;
 
-    int string_to_int(const std::string& str) const {
-        int length = static_cast<int>(str.length());
-        int answer = 0;
+    Tracer* tracer = nullptr; // tracing 중일 때만 설정: 새 symbol을 추가할 때 기록
 
-        if (length % 2 == 1) {
-            answer = str.at(length - 1);
-            length--;
+    // FNV-1a: 계산 결과로 추가되는 숫자처럼 글자가 비슷한 symbol도 고르게 흩어지도록 글자마다 섞음
+    // (글자의 합을 쓰면 숫자 symbol이 좁은 범위에 몰려 탐색 길이가 hash table 크기만큼 길어짐)
+    int string_to_int(const std::string& str) const {
+        uint32_t answer = 2166136261u;
+        for (const char c : str) {
+            answer ^= static_cast<unsigned char>(c);
+            answer *= 16777619u;
         }
 
-        for (int i = 0; i < length; i += 2) {
-            answer += str.at(i);
-            answer += (static_cast<int>(str.at(i + 1))) << 8;
-        }
+        return static_cast<int>(answer % (HASH_TABLE_SIZE - 1)) + 1;
+    }
 
-        return answer % (HASH_TABLE_SIZE - 1) + 1;
+    // 숫자는 자르면 다른 값이 되므로 MAX_SYMBOL_SIZE보다 길어도 그대로 저장
+    static void cut_symbol(std::string& input_str) {
+        double number = 0.0;
+        if (input_str.size() > MAX_SYMBOL_SIZE && !Numeric::parse(input_str, number)) {
+            input_str = input_str.substr(0, MAX_SYMBOL_SIZE);
+        }
     }
 
     public:
+    // @return hash table에 저장되는 symbol 이름. (MAX_SYMBOL_SIZE 이후는 잘림)
+    static std::string symbol_name(const std::string& input_str) {
+        return input_str.substr(0, MAX_SYMBOL_SIZE);
+    }
+
     int get_hash_value(std::string input_str) {
         // cut string which is out of MAX_SYMBOL_SIZE
-        if (input_str.size() > MAX_SYMBOL_SIZE) {
-            input_str = input_str.substr(0, MAX_SYMBOL_SIZE);
-        }
+        cut_symbol(input_str);
+        return intern(input_str, nullptr);
+    }
 
+    // @param text: Numeric::format(number)로 만든 문자열.
+    // @return text의 hash 값. (새 symbol이어도 text를 다시 변환하지 않음)
+    int get_number_hash_value(const std::string& text, const double number) {
+        return intern(text, &number);
+    }
+
+    private:
+    // @param number: input_str이 나타내는 숫자. (nullptr: 새 symbol이면 판별)
+    int intern(const std::string& input_str, const double* number) {
+        const long long start_ns = (tracer != nullptr) ? tracer->now_ns() : 0;
         int tmp_hash = string_to_int(input_str);
         const int orig_tmp_hash = tmp_hash;
+        int probes = 1;
+        int released_hash = 0; // 처음 지나간 지운 자리: symbol이 없으면 여기에 추가
 
-        while (hash_table[tmp_hash].symbol != "" && hash_table[tmp_hash].symbol != input_str) {
+        while (hash_table[tmp_hash].symbol != input_str && (hash_table[tmp_hash].symbol != "" || hash_table[tmp_hash].is_released)) {
+            if (released_hash == 0 && hash_table[tmp_hash].is_released) {
+                released_hash = tmp_hash;
+            }
+
+            probes++;
             tmp_hash++;
             if (tmp_hash >= HASH_TABLE_SIZE) {
-                tmp_hash = 0;
+                tmp_hash = 1; // 0은 nil
             }
 
             // hash table is full
             if (tmp_hash == orig_tmp_hash) {
+                if (released_hash != 0) break;
                 throw std::length_error("Size of the hash table is too small:" + std::to_string(HASH_TABLE_SIZE));
             }
         }
+        if (hash_table[tmp_hash].symbol != input_str && released_hash != 0) {
+            tmp_hash = released_hash;
+        }
 
         if (tmp_hash > max_nonzero_index) {
             max_nonzero_index = tmp_hash;
@@ -71,22 +122,44 @@ class HashTable {
             max_length_of_link_ptr = 1;
         }
 
-        hash_table[tmp_hash].symbol = input_str;
+        const bool is_new = hash_table[tmp_hash].symbol == "";
+        if (is_new) {
+            hash_table_struct& entry = hash_table[tmp_hash];
+            entry.is_released = false;
+            symbol_count++;
+            entry.serial = ++last_serial;
+            entry.symbol = input_str;
+            if (number != nullptr) {
+                entry.is_number = true;
+                entry.is_canonical = true;
+                entry.number = *number;
+            } else {
+                entry.is_number = Numeric::parse(input_str, entry.number);
+                entry.is_canonical = entry.is_number && Numeric::format(entry.number) == input_str;
+            }
+        }
+        if (tracer != nullptr && is_new) {
+            tracer->complete("symbol-table", nullptr, start_ns, "probes", probes, -tmp_hash);
+        }
         return -tmp_hash;
     }
 
+    public:
+    // @param new_tracer: 새 symbol을 기록할 tracer. (nullptr: 기록하지 않음)
+    void set_tracer(Tracer* new_tracer) {
+        tracer = new_tracer;
+    }
+
     bool is_existing(std::string input_str) {
         // cut string which is out of MAX_SYMBOL_SIZE
-        if (input_str.size() > MAX_SYMBOL_SIZE) {
-            input_str = input_str.substr(0, MAX_SYMBOL_SIZE);
-        }
+        cut_symbol(input_str);
 
         int tmp_hash = string_to_int(input_str);
         const int orig_tmp_hash = tmp_hash;
         while (hash_table[tmp_hash].symbol != input_str) {
             tmp_hash++;
             if (tmp_hash >= HASH_TABLE_SIZE) {
-                tmp_hash = 0;
+                tmp_hash = 1;
             }
 
             // hash table is full
@@ -113,10 +186,75 @@ class HashTable {
         return hash_table[-hash].symbol;
     }
 
+    bool is_number(const int hash) const {
+        check_size(-hash);
+        return hash_table[-hash].is_number;
+    }
+
+    // @return 계산 결과로 다시 만들어지는 형태(Numeric::format)의 숫자인지의 여부.
+    bool is_canonical_number(const int hash) const {
+        check_size(-hash);
+        return hash_table[-hash].is_canonical;
+    }
+
+    // @return is_number()인 symbol의 값.
+    double get_number(const int hash) const {
+        check_size(-hash);
+        return hash_table[-hash].number;
+    }
+
+    // 더 이상 쓰이지 않는 symbol을 지움 (GC 전용, 같은 자리를 거쳐 가는 다른 symbol을 찾을 수 있도록 빈 자리로 표시만 함)
+    // 값이 묶인 symbol은 지우지 않음
+    void release_symbol(const int hash) {
+        check_size(-hash);
+        hash_table_struct& entry = hash_table[-hash];
+        if (entry.symbol == "" || entry.link_of_value != 0) {
+            return;
+        }
+
+        entry = hash_table_struct();
+        entry.is_released = true;
+        symbol_count--;
+    }
+
+    // 남은 symbol의 탐색 경로(처음 자리부터 저장된 자리까지)에 없는 지운 자리는 빈 자리로 되돌림 (GC 후: 탐색 길이가 늘지 않도록)
+    void clear_released() {
+        std::vector<bool> on_path(HASH_TABLE_SIZE, false);
+        for (int i = 1; i < HASH_TABLE_SIZE; i++) {
+            if (hash_table[i].symbol == "") continue;
+
+            for (int j = string_to_int(hash_table[i].symbol); j != i; j = (j + 1 < HASH_TABLE_SIZE) ? j + 1 : 1) {
+                on_path[j] = true;
+            }
+        }
+
+        for (int i = 1; i < HASH_TABLE_SIZE; i++) {
+            if (hash_table[i].is_released && !on_path[i]) {
+                hash_table[i].is_released = false;
+            }
+        }
+    }
+
     int size() const {
         return HASH_TABLE_SIZE;
     }
 
+    // @return 지금까지 마지막으로 추가한 symbol의 serial. (이보다 큰 serial의 symbol은 그 뒤에 추가됨)
+    unsigned long long get_serial() const {
+        return last_serial;
+    }
+
+    // @return symbol이 serial 시점 뒤에 추가되었는지의 여부.
+    bool is_added_after(const int hash, const unsigned long long serial) const {
+        check_size(-hash);
+        return hash_table[-hash].serial > serial;
+    }
+
+    // @return 저장된 symbol의 수.
+    int get_symbol_count() const {
+        return symbol_count;
+    }
+
     const hash_table_struct* get_hash_table() const {
         return hash_table;
     }
@@ -149,10 +287,10 @@ class HashTable {
 
     void clear() {
         for (hash_table_struct& i : hash_table) {
-            i.symbol = "";
-            i.link_of_value = 0;
+            i = hash_table_struct();
         }
 
+        symbol_count = 0;
         max_nonzero_index = 0;
         max_length_of_symbol = 0;
         max_length_of_link_ptr = 0;
@@ -0,0 +1,37 @@
+#ifndef HEAP_OBJECT_H
+#define HEAP_OBJECT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/* node array 밖에 저장되는 scheme 값 (hash table 등)
+ * node array에는 head가 NodeArray::OBJECT_TAG인 cell 하나만 두고,
+ * interpreter가 그 cell의 index로 실제 object를 찾는다.
+ * GC는 cell이 살아 있는 동안 trace()가 알려 주는 값을 함께 보존한다.
+ */
+class HeapObject {
+    public:
+    virtual ~HeapObject() {}
+
+    // @return 출력할 때 사용할 type 이름. (예: hash-table)
+    virtual std::string type_name() const = 0;
+
+    // @param values: 이 object가 참조하는 scheme 값을 추가할 곳.
+    virtual void trace(std::vector<int>& values) const = 0;
+
+    // @return object가 차지하는 대략의 byte 수. (heap-snapshot의 크기 계산용, node array의 cell 제외)
+    virtual size_t heap_size() const = 0;
+
+    // @return 출력할 때의 문자열. (write 형식)
+    virtual std::string write_form() const {
+        return "#<" + type_name() + ">";
+    }
+
+    // @return display로 출력할 때의 문자열.
+    virtual std::string display_form() const {
+        return write_form();
+    }
+};
+
+#endif
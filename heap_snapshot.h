@@ -0,0 +1,107 @@
+#ifndef HEAP_SNAPSHOT_H
+#define HEAP_SNAPSHOT_H
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "tracer.h"
+
+/* heap snapshot (heap-snapshot)
+ * root에서 도달할 수 있는 cell과 heap object의 참조 graph를 JSON으로 쓴다.
+ * tools/heap_report.cpp가 이 file을 읽어 전역 binding마다 dominator 기준 retained size를 계산한다.
+ *
+ * {"version":1,
+ *  "types":["pair","string",...],
+ *  "nodes":[[id,type,size,[edge,...]],...],   type: types의 index, size: byte
+ *  "roots":[[kind,name,id],...]}              kind: global, shadowed, saved, generator, task, continuation, prepared
+ */
+class HeapSnapshot {
+    private:
+    struct node_struct {
+        int id = 0;
+        int type = 0;
+        size_t size = 0;
+        std::vector<int> edges;
+    };
+
+    struct root_struct {
+        std::string kind = "";
+        std::string name = "";
+        int id = 0;
+    };
+
+    std::vector<std::string> types;
+    std::unordered_map<std::string, int> type_indexes;
+    std::vector<node_struct> nodes;
+    std::vector<root_struct> roots;
+
+    public:
+    // @param id: root가 가리키는 cell.
+    void add_root(const std::string& kind, const std::string& name, const int id) {
+        root_struct root;
+        root.kind = kind;
+        root.name = name;
+        root.id = id;
+        roots.push_back(root);
+    }
+
+    // @param edges: 이 cell이 가리키는 cell.
+    void add_node(const int id, const std::string& type, const size_t size, const std::vector<int>& edges) {
+        const auto found = type_indexes.find(type);
+        int type_index = 0;
+        if (found == type_indexes.end()) {
+            type_index = static_cast<int>(types.size());
+            type_indexes[type] = type_index;
+            types.push_back(type);
+        } else {
+            type_index = found->second;
+        }
+
+        node_struct node;
+        node.id = id;
+        node.type = type_index;
+        node.size = size;
+        node.edges = edges;
+        nodes.push_back(node);
+    }
+
+    size_t node_count() const {
+        return nodes.size();
+    }
+
+    // @return file에 썼는지의 여부.
+    bool dump(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        file << "{\"version\":1,\n\"types\":[";
+        for (size_t i = 0; i < types.size(); i++) {
+            file << (i > 0 ? "," : "") << Tracer::quote(types[i]);
+        }
+
+        file << "],\n\"nodes\":[";
+        for (size_t i = 0; i < nodes.size(); i++) {
+            const node_struct& node = nodes[i];
+            file << (i > 0 ? ",\n" : "\n") << "[" << node.id << "," << node.type << "," << node.size << ",[";
+            for (size_t j = 0; j < node.edges.size(); j++) {
+                file << (j > 0 ? "," : "") << node.edges[j];
+            }
+            file << "]]";
+        }
+
+        file << "],\n\"roots\":[";
+        for (size_t i = 0; i < roots.size(); i++) {
+            const root_struct& root = roots[i];
+            file << (i > 0 ? ",\n" : "\n") << "[" << Tracer::quote(root.kind) << "," << Tracer::quote(root.name) << "," << root.id << "]";
+        }
+        file << "]}\n";
+
+        return static_cast<bool>(file);
+    }
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef HEAP_WALKER_H
+#define HEAP_WALKER_H
+
+#include <utility>
+#include <vector>
+
+/* node array 순회 engine
+ * tail은 반복문으로 따라가고 나중에 방문할 위치만 크기가 늘어나는 stack(std::vector)에 쌓는다.
+ * list의 길이와 관계없이 C++ stack 사용량이 일정하므로 매우 긴 list도 GC, equal?, 출력이 가능하다.
+ *  - for_each_value: 방문 순서가 상관없는 순회 (GC marking, hash 값 계산)
+ *  - is_equal: 두 구조를 동시에 순회하며 비교
+ *  - walk_in_order: 출력 순서대로 순회
+ * Heap: get_lchild(), get_rchild(), is_object()를 가진 node 저장소 (NodeArray)
+ */
+template <typename Heap>
+class HeapWalker {
+    private:
+    const Heap& node_array;
+
+    // @return index가 head, tail을 가진 node인지의 여부. (heap object cell 제외)
+    bool is_pair(const int index) const {
+        return index > 0 && !node_array.is_object(index);
+    }
+
+    public:
+    explicit HeapWalker(const Heap& node_array) : node_array(node_array) {}
+
+    /* root에서 도달할 수 있는 모든 값을 방문
+     * visit(value)는 0, symbol, heap object, node를 모두 받고,
+     * node에 대해 false를 반환하면 그 node의 head, tail은 방문하지 않는다. (이미 방문한 node 등)
+     */
+    template <typename Visit>
+    void for_each_value(const int root, Visit visit) const {
+        std::vector<int> heads;
+        heads.push_back(root);
+
+        while (!heads.empty()) {
+            int value = heads.back();
+            heads.pop_back();
+
+            // tail 방향은 반복문으로 진행
+            while (true) {
+                if (!visit(value) || !is_pair(value)) break;
+
+                heads.push_back(node_array.get_lchild(value));
+                value = node_array.get_rchild(value);
+            }
+        }
+    }
+
+    /* 두 값의 구조 비교
+     * compare(value1, value2)는 COMPARE_EQUAL, COMPARE_NOT_EQUAL,
+     * COMPARE_DESCEND(둘 다 node이므로 head와 tail을 비교) 중 하나를 반환한다.
+     */
+    enum compare_result { COMPARE_EQUAL, COMPARE_NOT_EQUAL, COMPARE_DESCEND };
+
+    template <typename Compare>
+    bool is_equal(const int index1, const int index2, Compare compare) const {
+        std::vector<std::pair<int, int>> heads;
+        heads.push_back(std::make_pair(index1, index2));
+
+        while (!heads.empty()) {
+            int value1 = heads.back().first, value2 = heads.back().second;
+            heads.pop_back();
+
+            while (true) {
+                const compare_result result = compare(value1, value2);
+                if (result == COMPARE_EQUAL) break;
+                if (result == COMPARE_NOT_EQUAL) return false;
+
+                heads.push_back(std::make_pair(node_array.get_lchild(value1), node_array.get_lchild(value2)));
+                value1 = node_array.get_rchild(value1);
+                value2 = node_array.get_rchild(value2);
+            }
+        }
+
+        return true;
+    }
+
+    /* 출력 순서대로 순회
+     * visitor.begin_list(): head 위치(또는 root)의 list 시작
+     * visitor.atom(value): 0, symbol, heap object (head와 tail 모두)
+     * visitor.end_list(): tail이 0인 node에 도달
+     * head가 list이면 현재 node를 stack에 넣고 head를 먼저 순회한 뒤 그 node의 tail부터 이어 간다.
+     */
+    template <typename Visitor>
+    void walk_in_order(const int root, Visitor& visitor) const {
+        if (!is_pair(root)) {
+            visitor.atom(root);
+            return;
+        }
+
+        std::vector<int> parents; // head를 순회한 뒤 tail을 이어서 순회할 node
+        int node = root;
+        visitor.begin_list();
+
+        while (true) {
+            const int head = node_array.get_lchild(node);
+            if (is_pair(head)) {
+                parents.push_back(node);
+                visitor.begin_list();
+                node = head;
+                continue;
+            }
+            visitor.atom(head);
+
+            // tail 처리: list가 끝나면 바깥 list의 tail로 돌아감
+            while (true) {
+                const int tail = node_array.get_rchild(node);
+                if (is_pair(tail)) {
+                    node = tail;
+                    break;
+                }
+
+                if (tail == 0) {
+                    visitor.end_list();
+                } else {
+                    visitor.atom(tail);
+                }
+
+                if (parents.empty()) return;
+                node = parents.back();
+                parents.pop_back();
+            }
+        }
+    }
+};
+
+#endif
@@ -1,13 +1,41 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include <algorithm>
+#include <climits>
+#include <cstdint>
 #include <cstring>
 #include <cmath>
+#include <deque>
 #include <string>
 #include <stdexcept>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "node_array.h"
 #include "hash_table.h"
+#include "heap_object.h"
+#include "heap_snapshot.h"
+#include "heap_walker.h"
+#include "jit_x86_64.h"
+#include "channel.h"
+#include "continuation.h"
+#include "escape_analysis.h"
+#include "generator.h"
+#include "library_index.h"
+#include "macro_expander.h"
+#include "merge_sort.h"
+#include "native_hash_table.h"
+#include "numeric.h"
+#include "port.h"
+#include "promise.h"
+#include "record.h"
+#include "scheme_value.h"
+#include "string_object.h"
+#include "tracer.h"
 
 inline int max(const int a, const int b) {
     return (a < b) ? b : a;
@@ -23,16 +51,24 @@ class Interpreter {
     int parse_tree_root_ptr = 1;
 
     int read_number_of_left_paren = 0;
+    bool read_in_string = false; // 문자열 literal 안의 괄호는 세지 않음
+    bool read_escaped = false;
+
+    struct binding_struct {
+        int hash = 0; // 매개변수 symbol의 hash 값
+        int link_of_value = 0;
+    };
 
     class EvalFuncStack {
-        private:
+        public:
         static const int MAX_PARAMS = 5;
 
-        hash_table_struct stack_array[MAX_PARAMS];
+        private:
+        binding_struct stack_array[MAX_PARAMS];
         int top_ptr = -1;
 
         public:
-        void push(const hash_table_struct& element) {
+        void push(const binding_struct& element) {
             try {
                 if (top_ptr >= MAX_PARAMS - 1) {
                     throw std::range_error("The stack is full!");
@@ -46,18 +82,22 @@ class Interpreter {
             stack_array[top_ptr] = element;
         }
 
-        void push(const std::string& func_name, const int value) {
-            hash_table_struct temp_element;
-            temp_element.symbol = func_name;
+        void push(const int hash, const int value) {
+            binding_struct temp_element;
+            temp_element.hash = hash;
             temp_element.link_of_value = value;
 
             push(temp_element);
         }
 
-        const hash_table_struct& top() const {
+        const binding_struct& top() const {
             return stack_array[top_ptr];
         }
 
+        const binding_struct& operator[](const int index) const {
+            return stack_array[index];
+        }
+
         int size() const {
             return top_ptr + 1;
         }
@@ -69,6 +109,70 @@ class Interpreter {
         }
     };
 
+    // 함수 호출, let 등이 묶은 변수: (symbol의 hash 값, 묶기 전의 값)
+    // 묶기 전의 값은 계산 도중의 GC 뒤에 복원해야 하므로 GC root로 보존
+    typedef Generator::Bindings BindingStack;
+
+    // let, do가 묶은 변수: 범위를 벗어나면 (오류, 예외 포함) 묶기 전의 값으로 복원
+    class BindingScope {
+        private:
+        HashTable& hash_table;
+        BindingStack& bindings; // 묶을 때 실행 중이던 흐름의 binding
+        const size_t mark;
+
+        public:
+        BindingScope(HashTable& hash_table, BindingStack& bindings)
+            : hash_table(hash_table), bindings(bindings), mark(bindings.size()) {}
+        BindingScope(const BindingScope&) = delete;
+        BindingScope& operator=(const BindingScope&) = delete;
+
+        ~BindingScope() {
+            while (bindings.size() > mark) {
+                hash_table.set_pointer(bindings.back().first, bindings.back().second);
+                bindings.pop_back();
+            }
+        }
+
+        // @return 묶은 자리의 번호. (set()으로 값만 바꿀 때 사용)
+        size_t bind(const int hash, const int value) {
+            bindings.push_back(std::make_pair(hash, hash_table.get_pointer(hash)));
+            hash_table.set_pointer(hash, value);
+            return bindings.size() - 1 - mark;
+        }
+
+        void set(const size_t slot, const int value) {
+            hash_table.set_pointer(bindings[mark + slot].first, value);
+        }
+    };
+
+    // map, let 등이 계산한 값을 모아 둔 vector: generator 안이면 범위를 벗어날 때까지 generator에 등록 (중단된 동안 GC root)
+    class ValueScope {
+        private:
+        Generator* generator; // 등록할 때 실행 중이던 generator (nullptr: generator 밖)
+
+        public:
+        ValueScope(Generator* generator, const std::vector<int>& values) : generator(generator) {
+            if (generator != nullptr) {
+                generator->value_vectors.push_back(&values);
+            }
+        }
+        ValueScope(const ValueScope&) = delete;
+        ValueScope& operator=(const ValueScope&) = delete;
+
+        ~ValueScope() {
+            if (generator != nullptr) {
+                generator->value_vectors.pop_back();
+            }
+        }
+    };
+
+    class ParseArenaFull: public std::exception {
+        public:
+        const char* what() const noexcept override {
+            return "The parse arena is full.";
+        }
+    };
+
     class GarbageCollectionPerformed: public std::exception {
         public:
         const char* what() const noexcept override {
@@ -76,15 +180,32 @@ class Interpreter {
         }
     };
 
+    // continuation을 호출함: 그 continuation을 만든 call/1cc까지 빠져나감
+    class ContinuationInvoked: public std::exception {
+        public:
+        const Continuation* continuation = nullptr;
+        int value = 0;
+
+        ContinuationInvoked(const Continuation* continuation, const int value) : continuation(continuation), value(value) {}
+
+        const char* what() const noexcept override {
+            return "A continuation has been invoked.";
+        }
+    };
+
+    // backtrace에는 node 포인터만 기록하고, 출력할 때(format_error) 문자열로 변환
     class InterpreterError: public std::exception {
         protected:
         std::string what_message = "";
-        int stack_count = 0;
+        std::vector<int> backtrace;
 
         public:
-        void stack_append(const std::string& item) {
-            what_message += std::to_string(stack_count) + ": " + item + "\n";
-            stack_count++;
+        void stack_append(const int index) {
+            backtrace.push_back(index);
+        }
+
+        const std::vector<int>& get_backtrace() const {
+            return backtrace;
         }
 
         const char* what() const noexcept override {
@@ -125,765 +246,4503 @@ class Interpreter {
         }
     };
 
-    int garbage_collection_count = 0;
+    class NotProcedure: public Interpreter::InterpreterError {
+        public:
+        NotProcedure() = delete;
+        NotProcedure(const std::string& operand) {
+            what_message = "SchemeError: '" + operand + "' is not a procedure\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-    void get_output(const int index, const bool is_start, std::string& output) const {
-        if (index == 0) {
-            output += "() ";
-        } else if (index < 0) {
-            output += hash_table.get_value(index) + " ";
-        } else { // if (index > 0)
-            if (is_start) {
-                output += "(";
-            }
+    // map, filter, fold에 값으로 넘길 수 없는 기본 함수 (또는 정의되지 않은 이름)
+    class BuiltinNotProcedure: public Interpreter::InterpreterError {
+        public:
+        BuiltinNotProcedure() = delete;
+        BuiltinNotProcedure(const std::string& name) {
+            what_message = "SchemeError: builtin '" + name + "' cannot be passed as a procedure\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-            get_output(node_array.at_head(index), true, output);
+    class BadSyntax: public Interpreter::InterpreterError {
+        public:
+        BadSyntax() = delete;
+        BadSyntax(const std::string& keyword) {
+            what_message = "SchemeError: bad syntax: " + keyword + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-            if (node_array.at_tail(index) != 0) {
-                get_output(node_array.at_tail(index), false, output);
-            } else {
-                if (*(output.end() - 1) == ' ') {
-                    *(output.end() - 1) = ')';
-                } else {
-                    output += ')';
-                }
-                output += ' ';
-            }
+    class WrongTypeError: public Interpreter::InterpreterError {
+        public:
+        WrongTypeError() = delete;
+        WrongTypeError(const std::string& expected, const std::string& operand) {
+            what_message = "SchemeError: '" + operand + "' is not " + expected + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
-    }
+    };
 
-    const std::string preprocessing() {
-        for (char& i : input_str) {
-            if (i == '\t') { // tab to space
-                i = ' ';
-            } else if (i >= 'A' && i <= 'Z') { // capital to lower
-                i += 'a' - 'A';
-            }
+    // hash-consing된 cell은 구조가 같은 다른 상수와 공유하므로 제자리에서 바꿀 수 없음
+    class SharedConstant: public Interpreter::InterpreterError {
+        public:
+        SharedConstant() = delete;
+        SharedConstant(const std::string& operand) {
+            what_message = "SchemeError: '" + operand + "' is a shared constant and cannot be modified\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
+    };
 
-        std::string temp_str = "";
-        temp_str = preprocessing(temp_str);
-        reset_tokenizer();
-        
-        return temp_str;
-    }
-
-    const std::string& preprocessing(std::string& new_command) {
-        std::string token_value = "";
-        while (token_value = get_next_token(), token_value != "_END_OF_LINE") {
-            if (token_value == "define") {
-                new_command.append(" " + token_value);
-
-                token_value = get_next_token();
-                if (token_value == "(") {
-                    // (define (square x) (* x x))
-                    // => (define square (lambda (x) (* x x)))
-                    token_value = get_next_token();
-                    new_command.append(" " + token_value + " ( lambda ( "); 
-                    preprocessing(new_command);
-                    new_command.append(" ) ");
-                } else {
-                    // non-function define
-                    new_command.append(" " + token_value);
-                }
-            } else if (token_value == "'") {
-                // '(a b c) => (quote (a b c))
-                new_command.append(" ( quote ");
-
-                int number_of_left_paren = 0;
-                do {
-                    token_value = get_next_token();
-                    new_command.append(" " + token_value);
-
-                    if (token_value == "(") {
-                        number_of_left_paren++;
-                    } else if (token_value == ")") {
-                        number_of_left_paren--;
-                    }
-                } while (number_of_left_paren > 0);
-                new_command.append(" ) ");
-            } else {
-                new_command.append(" " + token_value);
-            }
+    class MissingKey: public Interpreter::InterpreterError {
+        public:
+        MissingKey() = delete;
+        MissingKey(const std::string& key) {
+            what_message = "SchemeError: no value found for key: " + key + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
+    };
 
-        return new_command;
-    }
+    class LimitExceeded: public Interpreter::InterpreterError {
+        public:
+        LimitExceeded() = delete;
+        LimitExceeded(const std::string& limit_name, const long long limit) {
+            what_message = "SchemeError: " + limit_name + " limit exceeded (" + std::to_string(limit) + ")\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-    std::string get_next_token() {
-        std::string tmp_str = get_next_token_non_dec();
+    class IndexOutOfRange: public Interpreter::InterpreterError {
+        public:
+        IndexOutOfRange() = delete;
+        IndexOutOfRange(const std::string& index, const size_t length) {
+            what_message = "SchemeError: index " + index + " is out of range for a list of length " + std::to_string(length) + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-        if (is_number(tmp_str)) {
-            // 부동소수점 오차 제거
-            return trunc_decimal(tmp_str);
+    class OutOfMemory: public Interpreter::InterpreterError {
+        public:
+        OutOfMemory() = delete;
+        OutOfMemory(const std::string& reason) {
+            what_message = "SchemeError: out of memory: " + reason + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
+    };
 
-        return tmp_str;
-    }
+    class FileError: public Interpreter::InterpreterError {
+        public:
+        FileError() = delete;
+        FileError(const std::string& path) {
+            what_message = "SchemeError: cannot open file: " + path + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
+        }
+    };
 
-    std::string get_next_token_non_dec() {
-        if (input_str_read_ptr >= input_str.size()) {
-            return "_END_OF_LINE";
+    class MissingElseClause: public Interpreter::InterpreterError {
+        public:
+        MissingElseClause() {
+            what_message = "SchemeError: the last clause of cond must be else\n"
+                           "\n"
+                           "Current Eval Stack:\n"
+                           "-------------------------\n";
         }
+    };
 
-        if (input_str[input_str_read_ptr] == '(') {
-            input_str_read_ptr++;
-            return "(";
-        } else if (input_str[input_str_read_ptr] == ')') {
-            input_str_read_ptr++;
-            return ")";
-        } else if (input_str[input_str_read_ptr] == '\'') {
-            input_str_read_ptr++;
-            return "'";
-        } else if (input_str[input_str_read_ptr] == ' ') {
-            input_str_read_ptr++;
+    // 검사하지 않은 연산자가 cell을 symbol로 읽으려 한 경우 (hash table의 범위를 벗어난 index)
+    class InvalidOperand: public Interpreter::InterpreterError {
+        public:
+        InvalidOperand() = delete;
+        InvalidOperand(const std::string& detail) {
+            what_message = "SchemeError: invalid operand (" + detail + ")\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
+    };
 
-        std::string tmp_str = "";
-        while (input_str_read_ptr < input_str.size()) {
-            if (input_str[input_str_read_ptr] == '(') {
-                input_str_read_ptr++;
-                return "(";
-            } else if (input_str[input_str_read_ptr] == ')') {
-                if (tmp_str == "") {
-                    input_str_read_ptr++;
-                    return ")";
-                } else {
-                    return tmp_str;
-                }
-            } else if (input_str[input_str_read_ptr] == '\'') {
-                if (tmp_str == "") {
-                    input_str_read_ptr++;
-                    return "'";
-                } else {
-                    return tmp_str;
-                }
-            } else if (input_str[input_str_read_ptr] == ' ') {
-                input_str_read_ptr++;
-                if (tmp_str != "") {
-                    return tmp_str;
-                }
-            } else { // symbol
-                tmp_str += input_str[input_str_read_ptr];
-                input_str_read_ptr++;
-            }
+    class ControlError: public Interpreter::InterpreterError {
+        public:
+        ControlError() = delete;
+        ControlError(const std::string& reason) {
+            what_message = "SchemeError: " + reason + "\n" +
+                           "\n" +
+                           "Current Eval Stack:\n" +
+                           "-------------------------\n";
         }
+    };
 
-        return tmp_str;
+    // eval()이 오류로 중단되었음을 나타내는 반환값
+    // 오류 내용은 pending_error에 있으며, 각 eval() 단계는 자신의 식을 backtrace에 추가하고 그대로 반환
+    static const int EVAL_ERROR = INT_MIN;
+
+    InterpreterError pending_error;
+
+    // @return EVAL_ERROR.
+    int raise_error(const InterpreterError& error) {
+        pending_error = error;
+        return EVAL_ERROR;
     }
 
-    void reset_tokenizer() {
-        input_str_read_ptr = 0;
+    // @return EVAL_ERROR.
+    int raise_error(const int root, const InterpreterError& error) {
+        raise_error(error);
+        return propagate_error(root);
     }
 
-    const std::string trunc_decimal(const std::string& num_str) {
-        int iter_to = num_str.size();
-        bool decimal_point = false, no_more_del = false;
-        for (auto iter = num_str.rbegin(); iter != num_str.rend(); iter++) {
-            if (*iter == '.') {
-                decimal_point = true;
-                if (no_more_del == false) {
-                    iter_to = static_cast<int>(num_str.rend() - iter) - 1;
-                }
-                break;
+    // @return EVAL_ERROR.
+    int propagate_error(const int root) {
+        pending_error.stack_append(root);
+        return EVAL_ERROR;
+    }
 
-            } else if (no_more_del == false && *iter != '0') {
-                no_more_del = true;
-                iter_to = static_cast<int>(num_str.rend() - iter);
-            }
-        }
+    static const size_t MAX_BACKTRACE_LINES = 32; // 깊은 재귀에서 오류가 나도 출력 길이를 제한
+
+    std::string format_error(const InterpreterError& error) const {
+        std::string message = error.what();
+        const std::vector<int>& backtrace = error.get_backtrace();
 
-        if (decimal_point == true) {
-            return num_str.substr(0, iter_to);
+        for (size_t i = 0; i < backtrace.size() && i < MAX_BACKTRACE_LINES; i++) {
+            std::string curr_eval_call = "";
+            get_output(backtrace[i], true, curr_eval_call);
+            message += std::to_string(i) + ": " + curr_eval_call + "\n";
+        }
+        if (backtrace.size() > MAX_BACKTRACE_LINES) {
+            message += "... (" + std::to_string(backtrace.size() - MAX_BACKTRACE_LINES) + " more)\n";
         }
 
-        return num_str;
+        return message;
     }
 
-    bool is_number(const std::string& num_str) const {
-        if (num_str.size() == 0) return false;
+    int garbage_collection_count = 0;
+    int free_cells_after_gc = NodeArray::NODE_ARRAY_SIZE;     // 지난 GC 직후의 free list 크기
+    int free_symbols_after_gc = HashTable::HASH_TABLE_SIZE;   // 지난 GC 직후의 hash table 빈 자리
+    std::ostream* message_stream = &std::cout; // GC 등 interpreter 상태 메시지
 
-        char* end_str;
-        double result = std::strtod(num_str.c_str(), &end_str);
-        return (strlen(end_str) < 1);
+    Tracer tracer;
+    std::string trace_path = ""; // 종료할 때 trace를 쓸 file
+
+    // save_bindings() 당시의 전역 binding (index: -hash)
+    std::vector<int> binding_snapshot;
+    // save_bindings() 당시에 있던 symbol (index: -hash): 그 뒤에 추가된 symbol만 GC가 지울 수 있음
+    std::vector<bool> snapshot_symbols;
+
+    BindingStack main_bindings;
+    BindingStack* dynamic_bindings = &main_bindings; // 실행 중인 흐름(generator 밖 또는 generator)의 binding
+
+    void bind_dynamic(const int hash, const int value) {
+        dynamic_bindings->push_back(std::make_pair(hash, hash_table.get_pointer(hash)));
+        hash_table.set_pointer(hash, value);
     }
 
-    bool is_equal_structure(const int index1, const int index2) const {
-        if (index1 > 0 && index2 > 0) {
-            // node array
-            return is_equal_structure(get_lchild(index1), get_lchild(index2)) &&
-                   is_equal_structure(get_rchild(index1), get_rchild(index2));
-        } else if (index1 == 0 && index2 == 0) {
-            // null array
-            return true;
-        } else if (index1 < 0 && index2 < 0) {
-            // symbol
-            return index1 == index2;
-        } else {
-            return false;
+    // @param mark: 복원할 binding의 수. (묶기 전의 크기)
+    void unbind_dynamic(BindingStack& bindings, const size_t mark) {
+        while (bindings.size() > mark) {
+            hash_table.set_pointer(bindings.back().first, bindings.back().second);
+            bindings.pop_back();
         }
     }
 
-    int count_params(const int root) {
-        int argument = get_rchild(root);
-        if (argument == 0) return 0;
+    MacroExpander macro_expander{node_array, hash_table, [this]() { return parse_alloc(); }};
 
-        int argument_count = 1;
-        while (argument != 0) {
-            argument = get_rchild(argument);
-            argument_count++;
-        }
+    /* 명령의 parse tree는 node array의 parse arena에 읽고 다음 명령을 읽을 때 비운다.
+     * 계산 결과로 남을 수 있는 부분(quote, lambda, define한 함수, delay한 식)만 promote()로 main heap에 복사하므로
+     * main heap에는 정의 등이 가져간 구조만 남는다.
+     * arena보다 큰 명령은 main heap에 읽는다.
+     */
+    bool parsing_command = false;    // parse_input() 중
+    bool parse_into_main_heap = false; // arena가 가득 차 main heap에 다시 읽는 중
 
-        return argument_count - 1;
-    }
-    
-    // @param num_str: std::string 형태의 수.
-    // @return num_str을 double로 변환한 값.
-    double get_val(const std::string& num_str) {
-        char* end_str;
-        double result = std::strtod(num_str.c_str(), &end_str);
-        if (strlen(end_str) > 0) {
-            std::cerr << "Warn: '" << num_str << "' is not pure number. Using '" << result << "'.\n";
+    // @return 명령의 parse tree에 쓸 node.
+    int parse_alloc() {
+        if (!parsing_command || parse_into_main_heap) {
+            return node_array_alloc();
         }
 
-        return result;
+        const int index = node_array.arena_alloc();
+        if (index == 0) {
+            throw Interpreter::ParseArenaFull();
+        }
+        return index;
     }
 
-    inline int get_lchild(const int index) const {
-        return node_array.get_lchild(index);
-    }
+    // @return value가 parse arena의 node이면 main heap에 복사한 것, 아니면 value.
+    int promote(const int value) {
+        if (!node_array.is_arena(value)) {
+            return value;
+        }
 
-    inline int get_rchild(const int index) const {
-        return node_array.get_rchild(index);
+        std::unordered_map<int, int> copied; // macro 전개로 공유된 부분은 한 번만 복사
+        return promote_node(value, copied);
     }
 
-    int node_array_alloc() {
-        const int free_size = node_array.get_size_free_list();
+    int promote_node(int value, std::unordered_map<int, int>& copied) {
+        // list의 tail 방향은 반복문, head 방향만 재귀
+        int root_ptr = 0, last_ptr = 0;
+        while (node_array.is_arena(value)) {
+            const std::unordered_map<int, int>::const_iterator found = copied.find(value);
+            if (found != copied.end()) {
+                value = found->second;
+                break;
+            }
 
-        // 공간이 없을 경우 GC 수행
-        if (free_size <= 1) {
-            int roots[NodeArray::NODE_ARRAY_SIZE] = {0, };
-            int roots_size = 0;
+            const int new_ptr = node_array_alloc();
+            copied[value] = new_ptr;
+            node_array.set_head(new_ptr, promote_node(get_lchild(value), copied));
+            node_array.set_tail(new_ptr, 0);
 
-            for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
-                if (hash_table.get_pointer(-i) == 0) continue;
+            if (last_ptr == 0) {
+                root_ptr = new_ptr;
+            } else {
+                node_array.set_tail(last_ptr, new_ptr);
+            }
+            last_ptr = new_ptr;
+            value = get_rchild(value);
+        }
 
-                // 이미 넣은 root point가 아닐 경우에만 새로 삽입
-                int j = 0;
-                for (; j < roots_size; j++) {
-                    if (roots[j] == i) break;
-                }
+        if (last_ptr == 0) {
+            return value;
+        }
+        node_array.set_tail(last_ptr, value);
+        return root_ptr;
+    }
 
-                if (j == roots_size) {
-                    roots[roots_size] = hash_table.get_pointer(-i);
-                    roots_size++;
-                }
+    /* library 지연 읽기
+     * (require "lib")는 file의 최상위 define 위치만 색인하고, 정의되지 않은 symbol을 만났을 때
+     * 그 이름의 식만 읽어 계산한다. 계산 중에 읽으므로 parse tree는 arena가 아닌 main heap에 만든다.
+     * 색인은 지우지 않으므로 restore_bindings()로 정의가 사라져도 다시 읽을 수 있다.
+     */
+    LibraryIndex library_index;
+
+    // @param text: 식 하나의 원문.
+    // @param is_whole: text에 식 하나만 있었는지의 여부를 저장할 곳. (nullptr: 확인하지 않음)
+    // @return 읽고 macro를 전개한 parse tree. (main heap)
+    int parse_form(const std::string& text, bool* is_whole = nullptr) {
+        const std::string orig_input_str = input_str;
+        const int orig_read_ptr = input_str_read_ptr;
+
+        input_str = text;
+        reset_tokenizer();
+        preprocessing();
+
+        int form = 0;
+        try {
+            form = macro_expander.expand(read());
+            if (is_whole != nullptr) {
+                const std::string rest = get_next_token_non_dec();
+                *is_whole = (rest == "" || rest == "_END_OF_LINE");
             }
-            node_array.garbage_collection(roots, roots_size);
-            std::cout << "Garbage collection has done!\n";
+        } catch (...) {
+            input_str = orig_input_str;
+            input_str_read_ptr = orig_read_ptr;
+            throw;
+        }
+        input_str = orig_input_str;
+        input_str_read_ptr = orig_read_ptr;
 
-            garbage_collection_count++;
-            throw Interpreter::GarbageCollectionPerformed();
+        return form;
+    }
+
+    // @return library 식의 계산 결과. 오류가 발생하면 EVAL_ERROR.
+    int eval_library_form(const int root, const LibraryIndex::form_struct& form) {
+        std::string text = "";
+        if (!LibraryIndex::read_form(form, text)) {
+            return raise_error(root, Interpreter::FileError(form.path));
         }
 
-        int tmp = node_array.alloc();
-        return tmp;
+        const int result = eval(parse_form(text));
+        if (result == EVAL_ERROR) return propagate_error(root);
+        return result;
     }
 
-    public:
-    // @param input: 명령어 문자열.
-    // @return 명령어가 전부 입력되었는지의 여부.
-    bool read(const std::string& input) {
-        int orig_read_number_of_left_paren = read_number_of_left_paren;
-        std::string orig_input_str = input_str;
+    // @param symbol: 정의되지 않은 symbol.
+    // @return library에서 symbol의 정의를 읽어 계산했는지의 여부. 오류가 발생하면 EVAL_ERROR.
+    int load_definition(const int root, const int symbol) {
+        const LibraryIndex::form_struct* found = library_index.find(hash_table.get_value(symbol));
+        if (found == nullptr) {
+            return 0;
+        }
+
+        const LibraryIndex::form_struct form = *found; // 식 안의 require가 색인을 바꿀 수 있음
+        if (eval_library_form(root, form) == EVAL_ERROR) return EVAL_ERROR;
+        return 1;
+    }
+
+    // @return symbol의 값. (library에 정의가 있으면 읽은 뒤의 값) 오류가 발생하면 EVAL_ERROR.
+    int load_library_value(const int symbol) {
+        if (load_definition(symbol, symbol) == EVAL_ERROR) return EVAL_ERROR;
+        return hash_table.get_pointer(symbol);
+    }
+
+    // @param path: library file 경로. (없으면 ".scm"을 붙인 경로)
+    // @return 색인한 뒤 나머지 최상위 식을 계산했는지의 여부. 오류가 발생하면 EVAL_ERROR.
+    int require_library(const int root, const std::string& path) {
+        if (library_index.is_indexed(path) || library_index.is_indexed(path + ".scm")) {
+            return 1;
+        }
+
+        std::vector<LibraryIndex::form_struct> eager_forms;
+        if (!library_index.index_file(path, eager_forms) && !library_index.index_file(path + ".scm", eager_forms)) {
+            return raise_error(root, Interpreter::FileError(path));
+        }
+
+        for (const LibraryIndex::form_struct& form : eager_forms) {
+            if (eval_library_form(root, form) == EVAL_ERROR) return EVAL_ERROR;
+        }
+        return 1;
+    }
+
+    public:
+    enum class ExecutionMode {
+        TREE_WALK,        // 매번 parse tree를 순회하며 계산
+        CLOSURE_COMPILED  // lambda 본문을 functor tree로 한 번 변환한 후 재사용
+    };
+
+    // 최상위 명령 하나를 계산할 때의 한도 (0: 제한 없음)
+    struct eval_limits_struct {
+        long long max_steps = 0; // 계산 단계: list 식 하나의 계산, 함수 호출 한 번
+        long long max_cells = 0; // 새로 할당하는 node array cell
+        int max_depth = 0;       // 함수 호출 깊이
+    };
+
+    private:
+    /* 계산 한도
+     * eval(output)을 시작할 때 남은 양을 한도로 채우고, 사용할 때마다 감소시켜 음수가 되면 중단한다.
+     * 한도가 없으면 최댓값으로 채우므로 hot loop의 비용은 감소와 부호 확인 한 번으로 같다.
+     *  - 계산 단계, 호출 깊이: LimitExceeded를 기록하고 EVAL_ERROR 반환
+     *  - cell: 할당한 cell을 돌려받는 곳에서는 EVAL_ERROR를 확인하지 않으므로 LimitExceeded를 throw
+     */
+    eval_limits_struct eval_limits;
+    long long steps_left = LLONG_MAX;
+    long long cells_left = LLONG_MAX; // 계산 중이 아닐 때(read 등)는 항상 최댓값
+    int depth_left = INT_MAX;
+
+    void start_eval_budget() {
+        steps_left = (eval_limits.max_steps > 0) ? eval_limits.max_steps : LLONG_MAX;
+        cells_left = (eval_limits.max_cells > 0) ? eval_limits.max_cells : LLONG_MAX;
+        depth_left = (eval_limits.max_depth > 0) ? eval_limits.max_depth : INT_MAX;
+    }
+
+    void end_eval_budget() {
+        steps_left = LLONG_MAX;
+        cells_left = LLONG_MAX;
+        depth_left = INT_MAX;
+    }
+
+    typedef std::function<int()> CompiledExpr;
+
+    struct compiled_lambda_struct {
+        int lambda_ptr = 0; // 변환할 당시의 (lambda ...) node 포인터
+        std::shared_ptr<const CompiledExpr> body;
+    };
+
+    ExecutionMode execution_mode = ExecutionMode::TREE_WALK;
+    std::unordered_map<int, compiled_lambda_struct> compiled_lambdas; // key: 함수 이름의 hash 값
+
+    static const int JIT_CALL_THRESHOLD = 100; // 이 횟수만큼 호출된 lambda를 기계어로 변환
 
+    struct jit_lambda_struct {
+        int lambda_ptr = 0; // 호출 횟수를 세기 시작할 당시의 (lambda ...) node 포인터
+        int call_count = 0;
+        bool rejected = false; // 변환할 수 없는 본문
+        std::unique_ptr<JitFunction> code;
+    };
+
+    bool jit_enabled = false;
+    std::unordered_map<int, jit_lambda_struct> jit_lambdas; // key: 함수 이름의 hash 값
+
+    std::unordered_map<int, std::unique_ptr<HeapObject>> heap_objects; // key: object cell의 index
+
+    // write, newline 등의 기본 출력 대상. with-output-to-file이 잠시 file port로 바꿈
+    OutputPort console_port{std::cout};
+    OutputPort* current_output_port = &console_port;
+
+    /* hash-consing
+     * quote된 data는 바뀌지 않으므로 (head, tail)이 같은 node를 하나만 만들어 공유한다.
+     * 같은 상수 list를 여러 번 읽어도 node가 늘어나지 않고,
+     * hash-consing된 두 값은 구조가 같으면 반드시 같은 node이므로 equal?이 포인터 비교로 끝난다.
+     * (quote된 문자열 literal도 내용이 같으면 같은 object를 공유해야 head가 같아짐)
+     */
+    bool hash_consing_enabled = false;
+    std::unordered_map<long long, int> hash_cons_table; // key: (head, tail), value: node 포인터
+    std::unordered_map<std::string, int> hash_consed_strings; // key: 문자열 내용, value: 문자열 object cell
+
+    /* 호출 단위 region 할당
+     * lambda를 처음 호출할 때 본문을 EscapeAnalyzer로 분석해, 호출이 끝나면 버려지는 cell을 만드는 cons 식을 표시해 둔다.
+     * 그 cons가 만든 cell은 region_cells에 기록했다가 호출이 끝날 때 한 번에 free list로 돌려주므로
+     * GC는 호출이 끝난 뒤에도 남는 cell만 보게 된다.
+     */
+    static const unsigned char REGION_SITE = 1;     // escape하지 않는 cons 식
+    static const unsigned char REGION_ANALYZED = 2; // 분석을 마친 lambda
+    std::vector<unsigned char> region_flags = std::vector<unsigned char>(NodeArray::TOTAL_SIZE, 0); // index: node 포인터
+    std::vector<int> region_cells; // 진행 중인 호출들의 region에 할당된 cell (안쪽 호출의 cell이 뒤에 옴)
+    int region_depth = 0;          // 진행 중인 lambda 호출의 수
+
+    // @param site: cons 식의 node 포인터.
+    // @return cons가 사용할 새 cell.
+    int alloc_cons(const int site) {
+        const int cell = node_array_alloc();
+        if (region_depth > 0 && current_generator == nullptr && (region_flags[site] & REGION_SITE)) {
+            region_cells.push_back(cell);
+        }
+        return cell;
+    }
+
+    void analyze_escapes(const int func_ptr) {
+        for (const int site : EscapeAnalyzer(node_array, hash_table).analyze(func_ptr)) {
+            region_flags[site] |= REGION_SITE;
+        }
+        region_flags[func_ptr] |= REGION_ANALYZED;
+    }
+
+    // @param mark: 호출을 시작할 때의 region_cells 크기. 그 뒤에 할당된 cell을 해제
+    void release_region(const size_t mark) {
+        for (size_t i = mark; i < region_cells.size(); i++) {
+            node_array.release(region_cells[i]);
+        }
+        region_cells.resize(mark);
+    }
+
+    /* generator와 one-shot continuation
+     * generator의 본문은 Coroutine이 따로 할당한 C++ stack에서 계산하므로, yield는 그 stack을 남겨 둔 채 호출한 쪽으로 돌아간다.
+     * 흐름마다 묶은 변수를 BindingStack에 기록해 두고, generator에 들어갈 때와 나올 때 hash table의 값과 맞바꾼다.
+     * 중단된 generator의 C++ stack에 남은 값은 GC 직전에 stack을 훑어 generator에 기록하고 (record_suspended_stacks()), generator가 GC root처럼 보고한다.
+     * 어디에서도 참조하지 않는 중단된 generator는 GC가 stack을 풀어 끝낸다.
+     * continuation은 C++ 예외로 call/1cc까지 빠져나가며, 중간의 generator는 그 예외로 끝난다.
+     */
+    static const size_t GENERATOR_STACK_MARGIN = 1 << 20; // generator 안의 함수 호출이 남겨 둘 stack (byte)
+    static const size_t JIT_FRAME_SIZE = 256;             // 기계어 함수의 재귀 한 번이 사용하는 stack의 상한 (byte)
+
+    Generator* current_generator = nullptr; // 실행 중인 generator (nullptr: generator 밖)
+    unsigned long long flow_serial = 0;     // 실행 흐름이 마지막으로 바뀐 때의 symbol serial (reclaim_loop_numbers())
+    std::vector<int> running_generators;    // 실행 중인 generator의 cell (GC root, 바깥쪽이 앞)
+    std::vector<int> active_continuations;  // 끝나지 않은 call/1cc의 continuation (GC root)
+
+    // @param entering: generator에 들어가면 true. (들어갈 때는 아래부터, 나올 때는 위부터 맞바꿈)
+    void swap_bindings(BindingStack& bindings, const bool entering) {
+        const size_t count = bindings.size();
+        for (size_t i = 0; i < count; i++) {
+            std::pair<int, int>& binding = bindings[entering ? i : count - 1 - i];
+            const int value = hash_table.get_pointer(binding.first);
+            hash_table.set_pointer(binding.first, binding.second);
+            binding.second = value;
+        }
+    }
+
+    // @param killing: 이어서 계산하지 않고 중단된 곳에서 stack을 풀어 끝낼지의 여부.
+    // @return generator가 끝났는지의 여부. 본문에서 빠져나온 예외는 다시 던짐.
+    bool switch_to_generator(const int cell, Generator* generator, const bool killing) {
+        Generator* orig_generator = current_generator;
+        BindingStack* orig_bindings = dynamic_bindings;
+        OutputPort* orig_port = current_output_port;
+        const int orig_depth_left = depth_left;
+
+        swap_bindings(generator->bindings, true);
+        current_generator = generator;
+        dynamic_bindings = &generator->bindings;
+        current_output_port = generator->output_port;
+        depth_left = generator->depth_left;
+        running_generators.push_back(cell);
+        flow_serial = hash_table.get_serial();
+
+        const auto leave = [&]() {
+            generator->output_port = current_output_port;
+            generator->depth_left = depth_left;
+            swap_bindings(generator->bindings, false);
+            if (generator->coroutine.is_done()) {
+                generator->bindings.clear(); // 처음에 묶은 변수만 남음
+            }
+
+            running_generators.pop_back();
+            current_generator = orig_generator;
+            dynamic_bindings = orig_bindings;
+            current_output_port = orig_port;
+            depth_left = orig_depth_left;
+            flow_serial = hash_table.get_serial();
+        };
+
+        bool finished = true;
         try {
-            // 괄호 개수 확인 -> 명령어가 전부 입력되었는지 확인
-            for (const char i : input) {
-                input_str += i;
-                if (i == '(') {
-                    read_number_of_left_paren++;
-                } else if (i == ')') {
-                    read_number_of_left_paren--;
-                }
+            if (killing) {
+                generator->coroutine.kill();
+            } else {
+                finished = generator->coroutine.resume();
+            }
+        } catch (const Interpreter::ContinuationInvoked&) { // 바깥의 continuation으로 빠져나감
+            leave();
+            throw;
+        } catch (...) { // GC, cell 한도 초과 등으로 명령이 중단됨
+            generator->abort();
+            leave();
+            throw;
+        }
+        leave();
+
+        return finished;
+    }
 
-                // 완전한 형태의 명령이 들어올 따마다 read 및 preprocessing
-                if (read_number_of_left_paren == 0) {
-                    reset_tokenizer();
-                    parse_tree_root_ptr = node_array.get_free_list_root();
-                    input_str = preprocessing();
-                    read();
+    // @param value: 중단된 yield가 반환할 값.
+    // @return yield한 값. generator가 끝났으면 eof object. 오류가 발생하면 EVAL_ERROR.
+    int resume_generator(const int root, const int cell, Generator* generator, const int value) {
+        if (generator->coroutine.is_running()) {
+            return raise_error(root, Interpreter::ControlError("generator is already running"));
+        } else if (generator->is_aborted()) {
+            return raise_error(root, Interpreter::ControlError("generator was aborted"));
+        } else if (generator->coroutine.is_done()) {
+            return eof_object();
+        }
 
-                    input_str = "";
-                }
+        generator->set_transfer(value);
+        if (!switch_to_generator(cell, generator, false)) {
+            return generator->get_transfer();
+        }
+
+        const int result = generator->get_transfer();
+        generator->set_transfer(0);
+        if (result == EVAL_ERROR) return propagate_error(root);
+        return eof_object();
+    }
+
+    // @return 중단된 generator와 task의 (cell, object).
+    std::vector<std::pair<int, Generator*>> suspended_generators() const {
+        std::vector<std::pair<int, Generator*>> suspended;
+        for (const auto& object : heap_objects) {
+            Generator* generator = dynamic_cast<Generator*>(object.second.get());
+            if (generator != nullptr && generator->coroutine.is_suspended()) {
+                suspended.push_back(std::make_pair(object.first, generator));
             }
+        }
 
-            // 명령어가 전부 입력되지 않음
-            if (read_number_of_left_paren != 0) {
-                return false;
+        return suspended;
+    }
+
+    // 중단된 곳에서 stack을 풀어 끝냄 (읽던 명령은 그대로 둠: load 도중 중단된 generator가 입력을 되돌리지 않도록)
+    void kill_generators(const std::vector<std::pair<int, Generator*>>& generators) {
+        const std::string orig_input_str = input_str;
+        const int orig_read_ptr = input_str_read_ptr;
+        for (const std::pair<int, Generator*>& entry : generators) {
+            switch_to_generator(entry.first, entry.second, true);
+            entry.second->abort();
+        }
+        input_str = orig_input_str;
+        input_str_read_ptr = orig_read_ptr;
+    }
+
+    // 중단된 generator를 모두 끝냄 (init, 소멸자)
+    void abort_suspended_generators() {
+        kill_generators(suspended_generators());
+    }
+
+    void close_continuation(const int cell, Continuation* continuation) {
+        continuation->close();
+        for (size_t i = active_continuations.size(); i > 0; i--) {
+            if (active_continuations[i - 1] == cell) {
+                active_continuations.erase(active_continuations.begin() + (i - 1));
+                break;
             }
+        }
+    }
 
-            return true;
-        } catch (Interpreter::GarbageCollectionPerformed& e) {
-            // GC 횟수가 2회 이상
-            if (garbage_collection_count > 1) {
-                throw std::length_error("Size of the node array is too small: " + std::to_string(NodeArray::NODE_ARRAY_SIZE));
+    // @return value가 procedure처럼 호출할 수 있는 heap object(generator, continuation, record procedure)인지의 여부. (task는 호출할 수 없음)
+    bool is_applicable_object(const int value) const {
+        const HeapObject* object = get_object(value);
+        const Generator* generator = dynamic_cast<const Generator*>(object);
+        return (generator != nullptr && !generator->is_task()) || dynamic_cast<const Continuation*>(object) != nullptr ||
+               dynamic_cast<const RecordProcedure*>(object) != nullptr;
+    }
+
+    // @param func_ptr: is_applicable_object()인 값.
+    // @return 호출 결과. 오류가 발생하면 EVAL_ERROR.
+    int apply_object(const int root, const int func_ptr, const EvalFuncStack& arg_values) {
+        HeapObject* object = get_object(func_ptr);
+
+        const RecordProcedure* record_procedure = dynamic_cast<const RecordProcedure*>(object);
+        if (record_procedure != nullptr) {
+            std::vector<int> values;
+            for (int i = 0; i < arg_values.size(); i++) {
+                values.push_back(arg_values[i].link_of_value);
             }
+            return apply_record_procedure(root, record_procedure, values);
+        }
 
-            read_number_of_left_paren = orig_read_number_of_left_paren;
-            input_str = orig_input_str;
+        Generator* generator = dynamic_cast<Generator*>(object);
+        if (generator != nullptr) {
+            // (g) 또는 (g value): 다음 yield까지 계산
+            if (arg_values.size() > 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, arg_values.size()));
+            }
+            return resume_generator(root, func_ptr, generator, arg_values.size() == 1 ? arg_values[0].link_of_value : 0);
+        }
 
-            bool result = read(input);
-            garbage_collection_count = 0;
-            return result;
+        // (k value): k를 만든 call/1cc가 value를 반환
+        Continuation* continuation = static_cast<Continuation*>(object);
+        if (arg_values.size() != 1) {
+            return raise_error(root, Interpreter::InconsistentArguments(1, arg_values.size()));
+        } else if (!continuation->is_active()) {
+            return raise_error(root, Interpreter::ControlError("continuation is no longer active"));
+        } else if (continuation->get_owner() != 0 &&
+                   std::find(running_generators.begin(), running_generators.end(), continuation->get_owner()) == running_generators.end()) {
+            return raise_error(root, Interpreter::ControlError("continuation belongs to a suspended generator"));
         }
+        throw Interpreter::ContinuationInvoked(continuation, arg_values[0].link_of_value);
     }
 
-    int read() {
-        int temp_ptr = 0;
-        int root_ptr = 0;
-        bool first = true;
+    // @param is_task: spawn이면 true.
+    // @return 새 generator 또는 task의 cell. 오류가 발생하면 EVAL_ERROR.
+    int make_generator(const int root, const int procedure, const bool is_task) {
+        if (!is_lambda(procedure) || get_lchild(get_rchild(procedure)) != 0) {
+            return raise_error(root, Interpreter::WrongTypeError("a procedure without parameters", get_output_string(procedure)));
+        }
+        if (!SCHEME_GENERATOR_AVAILABLE) {
+            return raise_error(root, Interpreter::ControlError("generators are not supported on this platform"));
+        }
 
-        std::string token_value = get_next_token();
+        // delay처럼 thunk가 참조하는 변수의 현재 값을 generator 안에서 다시 묶음
+        const int promoted = promote(procedure);
+        Generator* generator = new Generator(promoted, [this]() {
+            Generator* generator = current_generator;
+            generator->set_transfer(apply_lambda(0, generator->get_procedure(), EvalFuncStack()));
+        }, &console_port, (eval_limits.max_depth > 0) ? eval_limits.max_depth : INT_MAX, is_task);
+        generator->bindings = capture_bindings(get_lchild(get_rchild(get_rchild(promoted))));
 
-        if (token_value == "_END_OF_LINE") {
-            return root_ptr;
-        } else if (token_value == "(") {
-            while (token_value = get_next_token(), token_value != ")") {
-                if (first == true) {
-                    temp_ptr = node_array_alloc();
-                    root_ptr = temp_ptr;
+        return make_object(generator);
+    }
 
-                    first = false;
-                } else {
-                    node_array.set_tail(temp_ptr, node_array_alloc());
-                    temp_ptr = node_array[temp_ptr].tail;
+    /* task scheduler
+     * spawn한 task는 OS thread 없이 generator와 같은 Coroutine으로 실행하며, 흐름마다 binding, 출력 port, 호출 깊이를 따로 둔다.
+     * (input_str 등 읽기 상태는 명령 사이에만 쓰이므로 task가 나누어 가질 필요가 없음)
+     * task 밖의 흐름이 (yield)하거나 channel에서 기다리는 동안에만 준비된 task를 차례로 하나씩 실행하고,
+     * task는 (yield)하거나 channel에서 기다릴 때 scheduler로 돌아온다.
+     * task의 stack은 주소 공간만 예약하므로 실제 메모리는 사용한 page만큼만 든다.
+     * 끝나지 않은 task는 GC root이고 중단된 stack의 값은 generator처럼 보존되므로, 기다리는 task는 GC를 거쳐도 이어서 실행된다.
+     */
+    std::deque<int> ready_tasks;        // 실행할 차례인 task의 cell
+    std::unordered_set<int> live_tasks; // 끝나지 않은 task의 cell (GC root)
+
+    // @return task를 깨웠는지의 여부. (이미 끝난 task는 깨우지 않음)
+    bool wake_task(const int cell) {
+        Generator* task = dynamic_cast<Generator*>(get_object(cell));
+        if (task == nullptr || task->coroutine.is_done()) {
+            return false;
+        }
+
+        task->set_blocked(false);
+        ready_tasks.push_back(cell);
+        return true;
+    }
+
+    // 끝난 task를 목록에서 지움 (GC 직전)
+    void prune_tasks() {
+        for (auto iter = live_tasks.begin(); iter != live_tasks.end();) {
+            const Generator* task = dynamic_cast<const Generator*>(get_object(*iter));
+            if (task == nullptr || task->coroutine.is_done()) {
+                iter = live_tasks.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+
+        std::deque<int> ready;
+        for (const int cell : ready_tasks) {
+            if (live_tasks.count(cell) != 0) {
+                ready.push_back(cell);
+            }
+        }
+        ready_tasks.swap(ready);
+    }
+
+    // 준비된 task 하나를 다음 (yield)나 기다리는 곳까지 실행
+    // @return 실행한 task가 있으면 1, 없으면 0. task에서 오류가 발생하면 EVAL_ERROR.
+    int run_next_task(const int root) {
+        while (!ready_tasks.empty()) {
+            const int cell = ready_tasks.front();
+            ready_tasks.pop_front();
+
+            Generator* task = dynamic_cast<Generator*>(get_object(cell));
+            if (task == nullptr || task->coroutine.is_done()) {
+                continue;
+            }
+
+            // 예외로 빠져나가면 (continuation, GC) task는 끝난 것이므로 먼저 목록에서 지움
+            live_tasks.erase(cell);
+            if (switch_to_generator(cell, task, false)) {
+                const int result = task->get_transfer();
+                task->set_transfer(0);
+                if (result == EVAL_ERROR) return propagate_error(root);
+            } else {
+                live_tasks.insert(cell);
+                if (!task->is_blocked()) {
+                    ready_tasks.push_back(cell);
                 }
+            }
+            return 1;
+        }
 
-                if (token_value == "(") {
-                    input_str_read_ptr--;
-                    node_array.set_head(temp_ptr, read());
+        return 0;
+    }
+
+    // @param for_value: 값을 기다리면 true, 빈 자리를 기다리면 false.
+    // @return 오류가 발생하면 EVAL_ERROR.
+    int wait_on_channel(const int root, Channel* channel, const bool for_value) {
+        while (for_value ? channel->is_empty() : channel->is_full()) {
+            if (current_generator == nullptr) {
+                // task 밖: 기다리는 동안 task를 실행
+                const int ran = run_next_task(root);
+                if (ran == EVAL_ERROR) return EVAL_ERROR;
+                if (ran == 0) {
+                    return raise_error(root, Interpreter::ControlError(for_value ? "deadlock: no task can put a value into the channel"
+                                                                                 : "deadlock: no task can take a value from the channel"));
+                }
+            } else if (!current_generator->is_task()) {
+                return raise_error(root, Interpreter::ControlError("cannot wait on a channel inside a generator"));
+            } else {
+                const int cell = running_generators.back();
+                if (for_value) {
+                    channel->wait_for_value(cell);
                 } else {
-                    node_array.set_head(temp_ptr, hash_table.get_hash_value(token_value));
+                    channel->wait_for_space(cell);
                 }
-                node_array.set_tail(temp_ptr, 0);
+                current_generator->set_blocked(true);
+                current_generator->coroutine.yield();
             }
+        }
 
-            return root_ptr;
-        } else {
-            return hash_table.get_hash_value(token_value);
+        return 0;
+    }
+
+    // @return 계산한 channel. 오류가 발생하면 nullptr.
+    Channel* eval_channel(const int root, const int expr) {
+        const int value = eval(expr);
+        if (value == EVAL_ERROR) {
+            propagate_error(root);
+            return nullptr;
+        }
+
+        Channel* channel = dynamic_cast<Channel*>(get_object(value));
+        if (channel == nullptr) {
+            raise_error(root, Interpreter::WrongTypeError("a channel", get_output_string(value)));
         }
+
+        return channel;
     }
 
-    void eval() {
-        int result = 0;
+    static long long hash_cons_key(const int head, const int tail) {
+        return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(head)) << 32) |
+                                      static_cast<unsigned int>(tail));
+    }
+
+    // @return (head . tail) node. 이미 있으면 그 node를 재사용
+    int hash_cons(const int head, const int tail) {
+        const long long key = hash_cons_key(head, tail);
+        const std::unordered_map<long long, int>::const_iterator found = hash_cons_table.find(key);
+        if (found != hash_cons_table.end()) {
+            return found->second;
+        }
+
+        const int node_ptr = node_array_alloc();
+        node_array.set_head(node_ptr, head);
+        node_array.set_tail(node_ptr, tail);
+        hash_cons_table[key] = node_ptr;
+
+        return node_ptr;
+    }
+
+    bool is_hash_consed(const int index) const {
+        if (index <= 0 || hash_cons_table.empty()) {
+            return false;
+        }
+
+        const std::unordered_map<long long, int>::const_iterator found =
+            hash_cons_table.find(hash_cons_key(get_lchild(index), get_rchild(index)));
+        return found != hash_cons_table.end() && found->second == index;
+    }
+
+    typedef HeapWalker<NodeArray> Walker;
+
+    // get_output()의 출력 형식대로 문자열을 만드는 Walker visitor
+    class OutputVisitor {
+        private:
+        const Interpreter& interpreter;
+        std::string& output;
+        bool skip_begin; // 첫 list의 '(' 생략
+        bool is_display; // 문자열을 따옴표 없이 출력
+
+        public:
+        OutputVisitor(const Interpreter& interpreter, std::string& output, const bool skip_begin, const bool is_display)
+            : interpreter(interpreter), output(output), skip_begin(skip_begin), is_display(is_display) {}
+
+        void begin_list() {
+            if (skip_begin) {
+                skip_begin = false;
+            } else {
+                output += "(";
+            }
+        }
+
+        void atom(const int value) {
+            if (value == 0) {
+                output += "() ";
+            } else if (value < 0) {
+                output += interpreter.hash_table.get_value(value) + " ";
+            } else { // heap object
+                const HeapObject& object = *interpreter.heap_objects.at(value);
+                output += (is_display ? object.display_form() : object.write_form()) + " ";
+            }
+        }
+
+        void end_list() {
+            if (*(output.end() - 1) == ' ') {
+                *(output.end() - 1) = ')';
+            } else {
+                output += ')';
+            }
+            output += ' ';
+        }
+    };
+
+    // @param is_display: display 형식(문자열을 따옴표 없이)으로 출력할지의 여부.
+    void get_output(const int index, const bool is_start, std::string& output, const bool is_display = false) const {
+        OutputVisitor visitor(*this, output, !is_start, is_display);
+        Walker(node_array).walk_in_order(index, visitor);
+    }
+
+    void preprocessing() {
+        bool in_string = false, escaped = false;
+        for (char& i : input_str) {
+            if (in_string) { // 문자열 literal은 그대로
+                if (escaped) {
+                    escaped = false;
+                } else if (i == '\\') {
+                    escaped = true;
+                } else if (i == '"') {
+                    in_string = false;
+                }
+            } else if (i == '"') {
+                in_string = true;
+            } else if (i == '\t' || i == '\n' || i == '\r') { // tab, newline to space
+                i = ' ';
+            } else if (i >= 'A' && i <= 'Z') { // capital to lower
+                i += 'a' - 'A';
+            }
+        }
+    }
+
+    // 입력된 명령 하나를 읽고 macro를 전개
+    void parse_input() {
+        const long long start_ns = tracer.is_enabled() ? tracer.now_ns() : 0;
+        reset_tokenizer();
+        preprocessing();
 
+        // 이전 명령의 parse tree는 더 이상 쓰이지 않음
+        node_array.reset_arena();
+        parsing_command = true;
         try {
-            result = eval(parse_tree_root_ptr);
-        } catch (Interpreter::InterpreterError& error) {
-            std::cerr << error.what();
-            return;
+            parse_tree_root_ptr = macro_expander.expand(read());
+        } catch (...) {
+            parsing_command = false;
+            throw;
         }
+        parsing_command = false;
 
-        if (result == 0) {
-            std::cout << "()\n\n";
-        } else if (result < 0) {
-            // hash
-            std::cout << hash_table.get_value(result) << "\n\n";
-        } else { // if (result > 0)
-            // node pointer
-            std::string output = "";
-            get_output(result, true, output);
-            std::cout << output << "\n\n"; 
+        collect_garbage_between_commands(parse_tree_root_ptr);
+
+        if (tracer.is_enabled()) {
+            tracer.complete("reader", "read", start_ns, "chars", static_cast<long long>(input_str.size()));
+        }
+        input_str = "";
+    }
+
+    std::string get_next_token() {
+        std::string tmp_str = get_next_token_non_dec();
+
+        double number = 0.0;
+        if (Numeric::parse(tmp_str, number)) {
+            // 계산 결과와 같은 형태로 (1.50 -> 1.5, 1e3 -> 1000)
+            return Numeric::format(number);
+        }
+
+        return tmp_str;
+    }
+
+    std::string get_next_token_non_dec() {
+        if (input_str_read_ptr >= input_str.size()) {
+            return "_END_OF_LINE";
+        }
+
+        if (input_str[input_str_read_ptr] == '(') {
+            input_str_read_ptr++;
+            return "(";
+        } else if (input_str[input_str_read_ptr] == ')') {
+            input_str_read_ptr++;
+            return ")";
+        } else if (input_str[input_str_read_ptr] == '\'') {
+            input_str_read_ptr++;
+            return "'";
+        } else if (input_str[input_str_read_ptr] == ' ') {
+            input_str_read_ptr++;
+        }
+
+        std::string tmp_str = "";
+        while (input_str_read_ptr < input_str.size()) {
+            if (input_str[input_str_read_ptr] == '(') {
+                input_str_read_ptr++;
+                return "(";
+            } else if (input_str[input_str_read_ptr] == ')') {
+                if (tmp_str == "") {
+                    input_str_read_ptr++;
+                    return ")";
+                } else {
+                    return tmp_str;
+                }
+            } else if (input_str[input_str_read_ptr] == '\'') {
+                if (tmp_str == "") {
+                    input_str_read_ptr++;
+                    return "'";
+                } else {
+                    return tmp_str;
+                }
+            } else if (input_str[input_str_read_ptr] == ' ') {
+                input_str_read_ptr++;
+                if (tmp_str != "") {
+                    return tmp_str;
+                }
+            } else if (input_str[input_str_read_ptr] == '"') {
+                if (tmp_str == "") {
+                    return get_string_token();
+                } else {
+                    return tmp_str;
+                }
+            } else { // symbol
+                tmp_str += input_str[input_str_read_ptr];
+                input_str_read_ptr++;
+            }
         }
+
+        return tmp_str;
     }
 
-    // @param root: root node 포인터.
-    // @return 결과 해시 값 또는 node 포인터.
-    int eval(const int root) {
-        try {
-            if (root == 0) {
-                return 0;
+    // @return 따옴표를 포함한 문자열 literal 원문.
+    std::string get_string_token() {
+        std::string token = "\"";
+        size_t read_ptr = static_cast<size_t>(input_str_read_ptr) + 1;
+
+        bool escaped = false;
+        while (read_ptr < input_str.size()) {
+            const char c = input_str[read_ptr++];
+            token += c;
+            if (escaped) {
+                escaped = false;
+            } else if (c == '\\') {
+                escaped = true;
+            } else if (c == '"') {
+                break;
+            }
+        }
+
+        input_str_read_ptr = static_cast<int>(read_ptr);
+        return token;
+    }
+
+    void reset_tokenizer() {
+        input_str_read_ptr = 0;
+    }
+
+    bool is_number(const std::string& num_str) const {
+        double number = 0.0;
+        return Numeric::parse(num_str, number);
+    }
+
+    // @return 출력할 때의 문자열. (끝의 공백 제외)
+    std::string get_output_string(const int index) const {
+        std::string output = "";
+        get_output(index, true, output);
+        output.erase(output.find_last_not_of(' ') + 1);
+        return output;
+    }
+
+    bool is_equal_structure(const int index1, const int index2) const {
+        return Walker(node_array).is_equal(index1, index2, [this](const int value1, const int value2) {
+            if (value1 == value2) {
+                // 같은 symbol, null, node, heap object
+                return Walker::COMPARE_EQUAL;
+            } else if (is_hash_consed(value1) && is_hash_consed(value2)) {
+                // 구조가 같은 hash-consing된 값은 같은 node
+                return Walker::COMPARE_NOT_EQUAL;
+            } else if (get_string(value1) != nullptr && get_string(value2) != nullptr) {
+                // 문자열은 내용을 비교
+                return (get_string(value1)->get() == get_string(value2)->get()) ? Walker::COMPARE_EQUAL : Walker::COMPARE_NOT_EQUAL;
+            } else if (node_array.is_object(value1) || node_array.is_object(value2)) {
+                // 그 외의 heap object는 같은 object일 때만 같음
+                return Walker::COMPARE_NOT_EQUAL;
+            } else if (value1 > 0 && value2 > 0) {
+                // node array
+                return Walker::COMPARE_DESCEND;
+            } else {
+                return Walker::COMPARE_NOT_EQUAL;
+            }
+        });
+    }
+
+    int count_params(const int root) {
+        int argument = get_rchild(root);
+        if (argument == 0) return 0;
+
+        int argument_count = 1;
+        while (argument != 0) {
+            argument = get_rchild(argument);
+            argument_count++;
+        }
+
+        return argument_count - 1;
+    }
+    
+    // @param num_str: std::string 형태의 수.
+    // @return num_str을 double로 변환한 값.
+    double get_val(const std::string& num_str) {
+        char* end_str;
+        double result = std::strtod(num_str.c_str(), &end_str);
+        if (strlen(end_str) > 0) {
+            std::cerr << "Warn: '" << num_str << "' is not pure number. Using '" << result << "'.\n";
+        }
+
+        return result;
+    }
+
+    inline int get_lchild(const int index) const {
+        return node_array.get_lchild(index);
+    }
+
+    inline int get_rchild(const int index) const {
+        return node_array.get_rchild(index);
+    }
+
+    // @param command_root: 보존할 명령의 parse tree. (parse arena의 node는 표시하지 않고 따라가기만 함)
+    // @param is_routine: 공간이 모자라기 전에 명령 사이에서 미리 수행하는지의 여부. (알림을 출력하지 않음)
+    void collect_garbage(const int command_root = 0, const bool is_routine = false) {
+        if (tracer.is_enabled()) {
+            tracer.begin("gc", "collect");
+        }
+        prune_tasks();
+        const std::vector<std::pair<int, Generator*>> suspended = record_suspended_stacks();
+
+        // hash table의 크기가 node array보다 클 수 있으므로 root 개수를 제한하지 않음
+        std::vector<int> roots;
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            if (hash_table.get_pointer(-i) > 0) {
+                roots.push_back(hash_table.get_pointer(-i));
+            }
+        }
+
+        // 복원할 수 있도록 저장해 둔 binding도 보존
+        for (const int value : binding_snapshot) {
+            if (value > 0) {
+                roots.push_back(value);
+            }
+        }
+        for (const std::pair<int, int>& binding : main_bindings) {
+            if (binding.second > 0) {
+                roots.push_back(binding.second);
+            }
+        }
+        for (const int cell : running_generators) {
+            roots.push_back(cell);
+        }
+        for (const int cell : live_tasks) {
+            roots.push_back(cell);
+        }
+        for (const int cell : active_continuations) {
+            roots.push_back(cell);
+        }
+        for (const prepared_struct& form : prepared_forms) {
+            if (form.root > 0) {
+                roots.push_back(form.root);
+            }
+        }
+        for (const std::pair<const int, int>& loop : loop_lambdas) {
+            roots.push_back(loop.second);
+        }
+        std::vector<int> macro_values;
+        macro_expander.trace(macro_values);
+        for (const int value : macro_values) {
+            if (value > 0) {
+                roots.push_back(value);
+            }
+        }
+        if (command_root > 0) {
+            roots.push_back(command_root);
+        }
+        node_array.garbage_collection(roots, [this](const int index, std::vector<int>& values) {
+            const auto object = heap_objects.find(index);
+            if (object != heap_objects.end()) {
+                object->second->trace(values);
+            }
+        });
+
+        // 어디에서도 참조하지 않는 중단된 generator는 heap object를 해제하기 전에 stack을 풀어 끝냄
+        std::vector<std::pair<int, Generator*>> unreachable;
+        for (const std::pair<int, Generator*>& entry : suspended) {
+            if (!node_array.is_marked(entry.first)) {
+                unreachable.push_back(entry);
+            }
+        }
+        kill_generators(unreachable);
+
+        // 보존되지 않은 cell의 heap object 해제
+        for (auto iter = heap_objects.begin(); iter != heap_objects.end();) {
+            if (node_array.is_marked(iter->first)) {
+                iter++;
+            } else {
+                iter = heap_objects.erase(iter);
+            }
+        }
+
+        // 해제된 node의 hash-consing 항목 삭제
+        for (auto iter = hash_cons_table.begin(); iter != hash_cons_table.end();) {
+            if (node_array.is_marked(iter->second)) {
+                iter++;
+            } else {
+                iter = hash_cons_table.erase(iter);
+            }
+        }
+        for (auto iter = hash_consed_strings.begin(); iter != hash_consed_strings.end();) {
+            if (node_array.is_marked(iter->second)) {
+                iter++;
+            } else {
+                iter = hash_consed_strings.erase(iter);
+            }
+        }
+
+        // 해제된 node의 분석 결과 삭제 (region의 cell은 GC가 이미 회수함)
+        for (int i = 0; i < NodeArray::NODE_ARRAY_SIZE; i++) {
+            if (!node_array.is_marked(i)) {
+                region_flags[i] = 0;
+            }
+        }
+        region_cells.clear();
+
+        // 회수된 named let의 lambda 삭제 (lambda는 다음 GC에 회수됨)
+        for (auto iter = loop_lambdas.begin(); iter != loop_lambdas.end();) {
+            if (is_freed_cell(iter->first)) {
+                iter = loop_lambdas.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+
+        // 해제된 lambda의 변환 결과 삭제 (같은 cell에 다른 lambda가 할당될 수 있음)
+        for (auto iter = compiled_lambdas.begin(); iter != compiled_lambdas.end();) {
+            if (is_freed_cell(iter->second.lambda_ptr)) {
+                iter = compiled_lambdas.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+        for (auto iter = jit_lambdas.begin(); iter != jit_lambdas.end();) {
+            if (is_freed_cell(iter->second.lambda_ptr)) {
+                iter = jit_lambdas.erase(iter);
+            } else {
+                iter++;
+            }
+        }
+
+        // trace 중에는 기록해 둔 symbol의 hash 값이 다른 symbol을 가리키지 않도록 지우지 않음
+        if (!tracer.is_enabled()) {
+            release_unused_symbols(macro_values, [this](const int index) { return node_array.is_marked(index); });
+        }
+        free_cells_after_gc = node_array.get_size_free_list();
+        free_symbols_after_gc = HashTable::HASH_TABLE_SIZE - 1 - hash_table.get_symbol_count();
+        if (!is_routine) {
+            *message_stream << "Garbage collection has done!\n";
+        }
+
+        if (tracer.is_enabled()) {
+            tracer.end("gc", "free", node_array.get_size_free_list());
+        }
+    }
+
+    /* 중단된 generator의 stack에 남은 값을 기록 (GC 직전)
+     * free list에 없는 cell의 index, hash table 범위의 symbol hash 값, heap object의 주소인 word를 값으로 본다.
+     * 숫자 등이 우연히 같은 값이어도 더 보존할 뿐이고, free list의 cell은 제외하므로 free list를 따라가지 않는다.
+     * @return 중단된 generator와 task의 (cell, object).
+     */
+    std::vector<std::pair<int, Generator*>> record_suspended_stacks() {
+        const std::vector<std::pair<int, Generator*>> suspended = suspended_generators();
+        if (suspended.empty()) {
+            return suspended;
+        }
+
+        const std::vector<bool> is_free = free_cell_flags();
+        std::unordered_map<uintptr_t, int> object_cells;
+        for (const auto& object : heap_objects) {
+            object_cells[reinterpret_cast<uintptr_t>(object.second.get())] = object.first;
+        }
+
+        const auto is_value = [&is_free](const int value) {
+            return (value < 0 && value > -HashTable::HASH_TABLE_SIZE) || (value > 0 && value < NodeArray::NODE_ARRAY_SIZE && !is_free[value]);
+        };
+        const auto object_cell = [&object_cells](const uintptr_t address) {
+            const auto found = object_cells.find(address);
+            return (found != object_cells.end()) ? found->second : 0;
+        };
+        for (const std::pair<int, Generator*>& entry : suspended) {
+            entry.second->record_stack_values(is_value, object_cell);
+        }
+
+        return suspended;
+    }
+
+    // @return cell마다 free list에 있는지의 여부.
+    std::vector<bool> free_cell_flags() const {
+        std::vector<bool> is_free(NodeArray::NODE_ARRAY_SIZE, false);
+        int cell = node_array.get_free_list_root();
+        for (int i = 0; i < node_array.get_size_free_list(); i++) {
+            is_free[cell] = true;
+            cell = get_rchild(cell);
+        }
+
+        return is_free;
+    }
+
+    bool is_freed_cell(const int index) const {
+        return index > 0 && !node_array.is_arena(index) && !node_array.is_marked(index);
+    }
+
+    /* symbol 회수
+     * 계산 결과인 숫자는 모두 hash table에 symbol로 추가되므로, 지우지 않으면 서로 다른 숫자를 계산할수록 hash table이 가득 찬다.
+     * 살아 있는 cell, heap object, 전역 binding, 저장해 둔 binding, macro 정의, 명령의 parse tree 어디에도 없는 숫자 symbol을 지운다.
+     * save_bindings() 뒤에 추가된 symbol도 값이 묶여 있지 않고 어디에서도 쓰이지 않으면 지운다. (server의 요청마다 새 이름을 읽어도 가득 차지 않도록)
+     * 계산 도중의 GC는 명령을 중단시키므로 C++ stack에 남은 hash 값은 다시 쓰이지 않는다. (중단된 generator의 stack에 남은 값은 generator가 보고함)
+     * 계산을 이어 가는 반복문의 safe point에서는 C++ stack에 남았을 수 있는 symbol을 지우지 않도록 young_serial 뒤에 추가된 숫자만 지운다.
+     */
+    // @param is_live: cell이 살아 있는지의 여부. (GC 직후: 표시된 cell, 명령 사이: free list에 없는 cell)
+    // @param young_serial: 0이 아니면 이 serial 뒤에 추가된 숫자 symbol만 지움. (reclaim_loop_numbers())
+    template <typename IsLive>
+    void release_unused_symbols(const std::vector<int>& macro_values, IsLive is_live, const unsigned long long young_serial = 0) {
+        std::vector<bool> used(HashTable::HASH_TABLE_SIZE, false);
+        const auto use = [&used](const int value) {
+            if (value < 0 && value > -HashTable::HASH_TABLE_SIZE) {
+                used[-value] = true;
+            }
+        };
+
+        std::vector<int> values;
+        for (int i = 1; i < NodeArray::NODE_ARRAY_SIZE; i++) {
+            if (!is_live(i)) continue;
+
+            const HeapObject* object = get_object(i);
+            if (object != nullptr) {
+                values.clear();
+                object->trace(values);
+                for (const int value : values) {
+                    use(value);
+                }
+            } else {
+                use(get_lchild(i));
+                use(get_rchild(i));
+            }
+        }
+        for (int i = 0; i < node_array.get_arena_size(); i++) {
+            use(get_lchild(NodeArray::NODE_ARRAY_SIZE + i));
+            use(get_rchild(NodeArray::NODE_ARRAY_SIZE + i));
+        }
+
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            use(hash_table.get_pointer(-i));
+        }
+        for (const int value : binding_snapshot) {
+            use(value);
+        }
+        for (const std::pair<int, int>& binding : main_bindings) {
+            use(binding.first);
+            use(binding.second);
+        }
+        for (const int value : macro_values) {
+            use(value);
+        }
+        for (const prepared_struct& form : prepared_forms) {
+            use(form.root);
+            for (const int param : form.params) {
+                use(param);
+            }
+        }
+        for (const auto& compiled : compiled_lambdas) {
+            use(compiled.first);
+        }
+        for (const auto& jit : jit_lambdas) {
+            use(jit.first);
+        }
+
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            if (used[i] || hash_table.get_value(-i) == "") continue;
+
+            if (young_serial != 0) {
+                if (hash_table.is_number(-i) && hash_table.is_added_after(-i, young_serial)) {
+                    hash_table.release_symbol(-i);
+                }
+                continue;
+            }
+            const bool is_session_symbol = !snapshot_symbols.empty() && !snapshot_symbols[i];
+            if (hash_table.is_number(-i) || is_session_symbol) {
+                hash_table.release_symbol(-i); // 값이 묶인 symbol은 남음
+            }
+        }
+        hash_table.clear_released();
+    }
+
+    // 명령 사이에서만 호출: promote()할 공간이 부족해 보이거나 남은 cell이 지난 GC 직후의 절반 아래로 줄었으면 GC 수행
+    // hash table 자리만 모자라면 표시 없이 symbol만 회수 (숫자를 많이 계산할 뿐인 명령마다 GC하지 않도록)
+    // (계산 도중에 공간이 모자라 GC하면 명령이 중단되므로 반복해서 계산하는 식이 중단되지 않도록 미리 회수)
+    // @param command_root: 읽었지만 아직 계산하지 않은 명령의 parse tree.
+    void collect_garbage_between_commands(const int command_root = 0) {
+        const int free_cells = node_array.get_size_free_list();
+        const int free_symbols = HashTable::HASH_TABLE_SIZE - 1 - hash_table.get_symbol_count();
+        const bool needs_promote_space = node_array.is_arena(command_root) && free_cells <= node_array.get_arena_size() + 1;
+        if (needs_promote_space || free_cells < free_cells_after_gc / 2) {
+            collect_garbage(command_root, true);
+        } else if (free_symbols < free_symbols_after_gc / 2) {
+            reclaim_unused_symbols();
+        }
+    }
+
+    /* GC 없이 symbol만 회수 (release_unused_symbols())
+     * free list에 없는 cell은 모두 살아 있다고 보므로, 이미 쓰이지 않는 cell이 가리키는 symbol은 다음 GC까지 남는다.
+     * 명령의 parse tree는 parse arena에 있거나 free list에 없으므로 따로 넘기지 않아도 보존된다.
+     */
+    void reclaim_unused_symbols() {
+        if (tracer.is_enabled()) {
+            return;
+        }
+
+        record_suspended_stacks();
+        std::vector<int> macro_values;
+        macro_expander.trace(macro_values);
+        const std::vector<bool> is_free = free_cell_flags();
+        release_unused_symbols(macro_values, [&is_free](const int index) { return !is_free[index]; });
+        free_symbols_after_gc = HashTable::HASH_TABLE_SIZE - 1 - hash_table.get_symbol_count();
+    }
+
+    /* 반복문의 숫자 symbol 회수 (do, named let이 다음 반복의 값을 묶은 직후: safe point)
+     * 반복할 때마다 새 숫자가 추가되므로 명령 사이까지 기다리면 반복 횟수가 hash table 크기에 묶인다.
+     * 반복문을 시작한 뒤, 또 실행 흐름이 마지막으로 바뀐 (generator에 들어가거나 나온) 뒤에 추가된 숫자만 지운다.
+     * 그런 숫자를 C++ stack에 둘 수 있는 것은 이미 끝난 본문과 step의 계산뿐이고, 바깥의 계산이 가진 값은 그 전에 추가되었다.
+     * hash table의 빈 자리가 지난 회수 직후의 절반 아래로 줄었을 때만 훑는다.
+     * @param loop_serial: 반복문을 시작할 때의 symbol serial.
+     */
+    void reclaim_loop_numbers(const unsigned long long loop_serial) {
+        const int free_symbols = HashTable::HASH_TABLE_SIZE - 1 - hash_table.get_symbol_count();
+        if (free_symbols >= free_symbols_after_gc / 2 || tracer.is_enabled()) {
+            return;
+        }
+
+        record_suspended_stacks();
+        std::vector<int> macro_values;
+        macro_expander.trace(macro_values);
+        const std::vector<bool> is_free = free_cell_flags();
+        release_unused_symbols(macro_values, [&is_free](const int index) { return !is_free[index]; },
+                               std::max(loop_serial, flow_serial));
+        free_symbols_after_gc = HashTable::HASH_TABLE_SIZE - 1 - hash_table.get_symbol_count();
+    }
+
+    int node_array_alloc() {
+        const int free_size = node_array.get_size_free_list();
+
+        // 공간이 없을 경우 GC 수행
+        if (free_size <= 1) {
+            collect_garbage();
+
+            garbage_collection_count++;
+            throw Interpreter::GarbageCollectionPerformed();
+        }
+
+        if (--cells_left < 0) {
+            throw Interpreter::LimitExceeded("cell allocation", eval_limits.max_cells);
+        }
+
+        int tmp = node_array.alloc();
+        return tmp;
+    }
+
+    // @param object: 새로 만든 heap object. (소유권을 가져감)
+    // @return object를 가리키는 cell의 index.
+    int make_object(HeapObject* object) {
+        std::unique_ptr<HeapObject> owned_object(object);
+
+        const int object_ptr = node_array_alloc();
+        node_array.set_head(object_ptr, NodeArray::OBJECT_TAG);
+        node_array.set_tail(object_ptr, 0);
+        heap_objects[object_ptr] = std::move(owned_object);
+
+        return object_ptr;
+    }
+
+    // @return value가 가리키는 heap object. heap object가 아니면 nullptr.
+    HeapObject* get_object(const int value) const {
+        if (!node_array.is_object(value)) {
+            return nullptr;
+        }
+
+        return heap_objects.at(value).get();
+    }
+
+    // equal?로 같은 값은 같은 hash 값을 가짐
+    size_t hash_structure(const int index) const {
+        size_t hash = 0;
+        Walker(node_array).for_each_value(index, [this, &hash](const int value) {
+            if (value > 0 && !node_array.is_object(value)) { // node
+                hash = hash * 31 + 1;
+                return true;
+            }
+            if (get_string(value) != nullptr) {
+                hash = hash * 31 + std::hash<std::string>()(get_string(value)->get());
+                return false;
+            }
+
+            hash = hash * 31 + static_cast<unsigned int>(value);
+            return false;
+        });
+
+        return hash;
+    }
+
+    // @return value가 가리키는 문자열. 문자열이 아니면 nullptr.
+    const StringObject* get_string(const int value) const {
+        return dynamic_cast<const StringObject*>(get_object(value));
+    }
+
+    // @param expr: 문자열을 계산할 식.
+    // @param value: 계산한 문자열의 내용을 저장할 곳.
+    // @return 오류 없이 문자열을 계산했는지의 여부.
+    bool eval_string(const int root, const int expr, std::string& value) {
+        const int result = eval(expr);
+        if (result == EVAL_ERROR) {
+            propagate_error(root);
+            return false;
+        }
+
+        const StringObject* string = get_string(result);
+        if (string == nullptr) {
+            raise_error(root, Interpreter::WrongTypeError("a string", get_output_string(result)));
+            return false;
+        }
+
+        value = string->get();
+        return true;
+    }
+
+    // @param expr: port를 계산할 식.
+    // @param expected: 오류 메시지에 쓸 port의 종류.
+    // @return 계산한 열린 port. 오류가 발생하면 nullptr.
+    template <typename Port>
+    Port* eval_port(const int root, const int expr, const std::string& expected) {
+        const int value = eval(expr);
+        if (value == EVAL_ERROR) {
+            propagate_error(root);
+            return nullptr;
+        }
+
+        Port* port = dynamic_cast<Port*>(get_object(value));
+        if (port == nullptr || !port->is_open()) {
+            raise_error(root, Interpreter::WrongTypeError(expected, get_output_string(value)));
+            return nullptr;
+        }
+
+        return port;
+    }
+
+    // @param argument: (port) 또는 (). 없으면 현재 출력 port.
+    // @return 출력할 port. 오류가 발생하면 nullptr.
+    OutputPort* eval_output_port(const int root, const int argument) {
+        if (argument == 0) {
+            return current_output_port;
+        }
+
+        return eval_port<OutputPort>(root, get_lchild(argument), "an open output port");
+    }
+
+    // @param expr: delay할 식.
+    // @return expr이 참조하는 symbol 중 현재 값이 있는 것과 그 값.
+    Promise::Bindings capture_bindings(const int expr) const {
+        Promise::Bindings bindings;
+        Walker(node_array).for_each_value(expr, [this, &bindings](const int value) {
+            if (value < 0 && hash_table.get_pointer(value) != 0) {
+                for (const std::pair<int, int>& binding : bindings) {
+                    if (binding.first == value) return false;
+                }
+                bindings.push_back(std::make_pair(value, hash_table.get_pointer(value)));
+            }
+
+            return value > 0 && !node_array.is_object(value);
+        });
+
+        return bindings;
+    }
+
+    // @param expr: delay할 식.
+    // @return 새로 만든 promise cell의 index.
+    int make_promise(const int expr) {
+        const int promoted_expr = promote(expr);
+        return make_object(new Promise(promoted_expr, capture_bindings(promoted_expr)));
+    }
+
+    // @param value: promise 또는 일반 값.
+    // @return promise의 값. 처음 force하면 저장해 둔 식을 계산하며, promise가 아닌 값은 그대로. 오류가 발생하면 EVAL_ERROR.
+    int force_promise(const int root, const int value) {
+        Promise* promise = dynamic_cast<Promise*>(get_object(value));
+        if (promise == nullptr) {
+            return value;
+        } else if (promise->is_forced()) {
+            return promise->get_value();
+        }
+
+        // delay할 당시의 값으로 묶어서 계산한 뒤 복원
+        // 계산 도중 같은 promise를 다시 force하면 bindings가 비워지므로 복사해 둠
+        const Promise::Bindings bound = promise->get_bindings();
+        BindingStack& bindings = *dynamic_bindings;
+        const size_t mark = bindings.size();
+        for (const std::pair<int, int>& binding : bound) {
+            bind_dynamic(binding.first, binding.second);
+        }
+
+        int result = 0;
+        try {
+            result = eval(promise->get_expr());
+        } catch (...) {
+            rebind(bound, bindings, mark);
+            throw;
+        }
+        rebind(bound, bindings, mark);
+
+        if (result == EVAL_ERROR) return propagate_error(root);
+
+        // 계산 도중 같은 promise가 먼저 계산되었으면 그 값을 사용
+        if (!promise->is_forced()) {
+            promise->set_value(result);
+        }
+        return promise->get_value();
+    }
+
+    // 계산 도중 define으로 바뀐 전역 변수는 그대로 두고 나머지만 되돌림
+    // @param mark: bound를 묶기 전 bindings의 크기.
+    void rebind(const Promise::Bindings& bound, BindingStack& bindings, const size_t mark) {
+        for (size_t i = bindings.size(); i > mark; i--) {
+            const std::pair<int, int>& binding = bindings[i - 1];
+            if (hash_table.get_pointer(binding.first) == bound[i - 1 - mark].second) {
+                hash_table.set_pointer(binding.first, binding.second);
+            }
+        }
+        bindings.resize(mark);
+    }
+
+    int eof_object() {
+        return hash_table.get_hash_value("#<eof>");
+    }
+
+    // @param text: datum 하나의 원문.
+    // @return 읽은 datum. (quote된 data처럼 읽으며 macro는 전개하지 않음)
+    int parse_datum(const std::string& text) {
+        const std::string orig_input_str = input_str;
+        const int orig_input_str_read_ptr = input_str_read_ptr;
+
+        input_str = text;
+        reset_tokenizer();
+        preprocessing();
+
+        int datum = 0;
+        try {
+            datum = read(true);
+        } catch (...) {
+            input_str = orig_input_str;
+            input_str_read_ptr = orig_input_str_read_ptr;
+            throw;
+        }
+
+        input_str = orig_input_str;
+        input_str_read_ptr = orig_input_str_read_ptr;
+        return datum;
+    }
+
+    // @param expr: hash table을 계산할 식.
+    // @return 계산한 hash table. 오류가 발생하면 nullptr.
+    NativeHashTable* eval_hash_table(const int root, const int expr) {
+        const int value = eval(expr);
+        if (value == EVAL_ERROR) {
+            propagate_error(root);
+            return nullptr;
+        }
+
+        NativeHashTable* table = dynamic_cast<NativeHashTable*>(get_object(value));
+        if (table == nullptr) {
+            raise_error(root, Interpreter::WrongTypeError("a hash table", get_output_string(value)));
+        }
+
+        return table;
+    }
+
+    /* record (define-record-type)
+     * 접근자와 변경자는 정의할 때 정한 record type의 cell을 비교하고 정해 둔 slot을 바로 읽고 쓴다.
+     */
+
+    // @param root: (define-record-type name (constructor field ...) predicate (field accessor [modifier]) ...) 식.
+    int define_record_type(const int root) {
+        const int name = get_lchild(get_rchild(root));
+        const int rest = get_rchild(get_rchild(root));
+        const std::string keyword = hash_table.get_value(get_lchild(root));
+        if (name >= 0 || rest <= 0 || get_rchild(rest) <= 0) {
+            return raise_error(root, Interpreter::BadSyntax(keyword));
+        }
+
+        const int constructor = get_lchild(rest);
+        const int predicate = get_lchild(get_rchild(rest));
+        if (constructor <= 0 || node_array.is_object(constructor) || get_lchild(constructor) >= 0 || predicate >= 0) {
+            return raise_error(root, Interpreter::BadSyntax(keyword));
+        }
+
+        // field 정의: slot 순서
+        std::vector<int> fields;
+        for (int clause = get_rchild(get_rchild(rest)); clause != 0; clause = get_rchild(clause)) {
+            const int field = get_lchild(clause);
+            if (field <= 0 || node_array.is_object(field) || get_lchild(field) >= 0 || get_rchild(field) <= 0 ||
+                get_lchild(get_rchild(field)) >= 0 || std::find(fields.begin(), fields.end(), get_lchild(field)) != fields.end()) {
+                return raise_error(root, Interpreter::BadSyntax(keyword));
+            }
+            const int modifier = get_rchild(get_rchild(field));
+            if (modifier != 0 && (get_lchild(modifier) >= 0 || get_rchild(modifier) != 0)) {
+                return raise_error(root, Interpreter::BadSyntax(keyword));
+            }
+            fields.push_back(get_lchild(field));
+        }
+
+        RecordType* type_object = new RecordType(hash_table.get_value(name), fields);
+        std::vector<size_t> constructor_slots;
+        for (int arg = get_rchild(constructor); arg != 0; arg = get_rchild(arg)) {
+            const int slot = type_object->find_field(get_lchild(arg));
+            if (slot < 0) {
+                delete type_object;
+                return raise_error(root, Interpreter::BadSyntax(keyword));
+            }
+            constructor_slots.push_back(static_cast<size_t>(slot));
+        }
+
+        const int type = make_object(type_object);
+        std::vector<std::pair<int, int>> definitions;
+        definitions.push_back(std::make_pair(name, type));
+        definitions.push_back(std::make_pair(get_lchild(constructor),
+                                             make_object(new RecordProcedure(RecordProcedure::Kind::CONSTRUCTOR, type, constructor_slots))));
+        definitions.push_back(std::make_pair(predicate,
+                                             make_object(new RecordProcedure(RecordProcedure::Kind::PREDICATE, type, std::vector<size_t>()))));
+        for (int clause = get_rchild(get_rchild(rest)); clause != 0; clause = get_rchild(clause)) {
+            const int field = get_lchild(clause);
+            const std::vector<size_t> slot(1, static_cast<size_t>(type_object->find_field(get_lchild(field))));
+            definitions.push_back(std::make_pair(get_lchild(get_rchild(field)),
+                                                 make_object(new RecordProcedure(RecordProcedure::Kind::ACCESSOR, type, slot))));
+            const int modifier = get_rchild(get_rchild(field));
+            if (modifier != 0) {
+                definitions.push_back(std::make_pair(get_lchild(modifier),
+                                                     make_object(new RecordProcedure(RecordProcedure::Kind::MODIFIER, type, slot))));
+            }
+        }
+
+        for (const std::pair<int, int>& definition : definitions) {
+            // 재정의된 함수의 변환 결과 무효화
+            compiled_lambdas.erase(definition.first);
+            jit_lambdas.erase(definition.first);
+            hash_table.set_pointer(definition.first, definition.second);
+        }
+
+        return root;
+    }
+
+    // @param arg_values: 계산이 끝난 인자 값. (생성자는 EvalFuncStack::MAX_PARAMS보다 많은 field를 받을 수 있음)
+    // @return 호출 결과. 오류가 발생하면 EVAL_ERROR.
+    int apply_record_procedure(const int root, const RecordProcedure* procedure, const std::vector<int>& arg_values) {
+        const RecordProcedure::Kind kind = procedure->get_kind();
+        const std::vector<size_t>& slots = procedure->get_arg_slots();
+        const RecordType* type = static_cast<const RecordType*>(get_object(procedure->get_type()));
+
+        if (kind == RecordProcedure::Kind::CONSTRUCTOR) {
+            if (arg_values.size() != slots.size()) {
+                return raise_error(root, Interpreter::InconsistentArguments(static_cast<int>(slots.size()), static_cast<int>(arg_values.size())));
+            }
+
+            Record* record = new Record(procedure->get_type(), type->get_name(), type->field_count());
+            for (size_t i = 0; i < slots.size(); i++) {
+                record->slots[slots[i]] = arg_values[i];
+            }
+            return make_object(record);
+        }
+
+        const int expected = (kind == RecordProcedure::Kind::MODIFIER) ? 2 : 1;
+        if (static_cast<int>(arg_values.size()) != expected) {
+            return raise_error(root, Interpreter::InconsistentArguments(expected, static_cast<int>(arg_values.size())));
+        }
+
+        Record* record = dynamic_cast<Record*>(get_object(arg_values[0]));
+        const bool is_instance = record != nullptr && record->get_type() == procedure->get_type();
+        if (kind == RecordProcedure::Kind::PREDICATE) {
+            return hash_table.get_hash_value(is_instance ? "#t" : "#f");
+        }
+        if (!is_instance) {
+            return raise_error(root, Interpreter::WrongTypeError("a " + type->get_name() + " record", get_output_string(arg_values[0])));
+        }
+
+        if (kind == RecordProcedure::Kind::ACCESSOR) {
+            return record->slots[slots[0]];
+        }
+        record->slots[slots[0]] = arg_values[1];
+        return arg_values[1];
+    }
+
+    /* 기본 list 함수 (length, append, reverse, map, filter, fold, assoc, list-ref)
+     * 원소를 반복문으로 vector에 모은 뒤 결과 list의 cell을 alloc_list()로 한 번에 할당한다.
+     * 사용자 함수를 인자로 받는 함수는 원소마다 apply_procedure()만 호출하므로
+     * Scheme으로 쓴 재귀 정의와 달리 원소마다 list를 따라가는 eval과 binding 복원이 없다.
+     */
+
+    // @param list: 원소를 모을 list.
+    // @param values: 원소를 추가할 곳.
+    // @return list가 올바른 list인지의 여부. (아니면 WrongTypeError를 기록)
+    bool list_elements(const int root, const int list, std::vector<int>& values) {
+        int cell = list;
+        while (cell > 0 && !node_array.is_object(cell)) {
+            values.push_back(get_lchild(cell));
+            cell = get_rchild(cell);
+        }
+
+        if (cell != 0) {
+            raise_error(root, Interpreter::WrongTypeError("a list", get_output_string(list)));
+            return false;
+        }
+        return true;
+    }
+
+    // @param expr: list를 계산할 식.
+    // @return 계산한 list가 올바른 list인지의 여부. 오류가 발생하면 false.
+    bool eval_list_elements(const int root, const int expr, std::vector<int>& values) {
+        const int list = eval(expr);
+        if (list == EVAL_ERROR) {
+            propagate_error(root);
+            return false;
+        }
+
+        return list_elements(root, list, values);
+    }
+
+    // @return tail로 이은 새 cell count개. (head는 호출한 쪽이 채움)
+    int alloc_list(const int count) {
+        if (count <= 0) {
+            return 0;
+        }
+
+        // 공간이 없을 경우 GC 수행
+        if (node_array.get_size_free_list() <= count) {
+            collect_garbage();
+
+            garbage_collection_count++;
+            throw Interpreter::GarbageCollectionPerformed();
+        }
+
+        cells_left -= count;
+        if (cells_left < 0) {
+            throw Interpreter::LimitExceeded("cell allocation", eval_limits.max_cells);
+        }
+
+        return node_array.alloc_chain(count);
+    }
+
+    // @param values: list의 원소.
+    // @param tail: 마지막 cell의 tail.
+    // @return 새로 만든 list의 root node 포인터.
+    int make_list_from(const std::vector<int>& values, const int tail = 0) {
+        if (values.empty()) {
+            return tail;
+        }
+
+        const int list_ptr = alloc_list(static_cast<int>(values.size()));
+        int cell = list_ptr;
+        for (size_t i = 0; i + 1 < values.size(); i++) {
+            node_array.set_head(cell, values[i]);
+            cell = get_rchild(cell);
+        }
+        node_array.set_head(cell, values.back());
+        node_array.set_tail(cell, tail);
+
+        return list_ptr;
+    }
+
+    // @param value: 숫자 symbol의 hash 값. (check_number_operand로 먼저 검사)
+    // @return value를 double로 변환한 값.
+    double to_number(const int value) {
+        // 검사를 거치지 않은 cell은 명령 단위 오류로 중단 (run_command가 처리)
+        if (value >= 0) {
+            throw Interpreter::NotNumberError(get_output_string(value));
+        }
+        // 숫자 symbol의 값은 hash table에 추가할 때 한 번만 변환해 둠
+        if (hash_table.is_number(value)) {
+            return hash_table.get_number(value);
+        }
+        return get_val(hash_table.get_value(value));
+    }
+
+    // @param number: 계산 결과.
+    // @return number를 나타내는 symbol의 hash 값. (되돌려 읽으면 같은 값이 되는 가장 짧은 표현)
+    int make_number(const double number) {
+        return hash_table.get_number_hash_value(Numeric::format(number), number);
+    }
+
+    // @return 숫자가 아닌 피연산자일 경우 NotNumberError를 기록하고 EVAL_ERROR.
+    int check_number_operand(const int value) {
+        // symbol이 아닐 때
+        if (value >= 0) {
+            std::string operand = "";
+            get_output(value, true, operand);
+            operand = operand.substr(0, operand.length() - 1);
+            return raise_error(Interpreter::NotNumberError(operand));
+        }
+        // symbol이지만 number가 아닐 때
+        if (!hash_table.is_number(value)) {
+            return raise_error(Interpreter::NotNumberError(hash_table.get_value(value)));
+        }
+
+        return value;
+    }
+
+    // @return func_ptr가 (lambda (param ...) body) 형태인지의 여부.
+    bool is_lambda(const int func_ptr) const {
+        return func_ptr > 0 && !node_array.is_object(func_ptr) && get_lchild(func_ptr) < 0 &&
+               hash_table.get_value(get_lchild(func_ptr)) == "lambda";
+    }
+
+    // @param func_hash: 호출할 함수 이름의 hash 값. (이름이 없는 lambda: 0)
+    // @param func_ptr: 호출할 lambda의 node 포인터.
+    // @param arg_values: 계산이 끝난 인자 값.
+    // @return 함수 본문의 결과 해시 값 또는 node 포인터. 오류가 발생하면 EVAL_ERROR.
+    int apply_lambda(const int func_hash, const int func_ptr, const EvalFuncStack& arg_values) {
+        if (!tracer.is_enabled()) {
+            return call_lambda(func_hash, func_ptr, arg_values);
+        }
+
+        tracer.begin("call", func_hash == 0 ? "lambda" : nullptr, func_hash);
+        int result = 0;
+        try {
+            result = call_lambda(func_hash, func_ptr, arg_values);
+        } catch (...) {
+            tracer.end("call");
+            throw;
+        }
+        tracer.end("call");
+
+        return result;
+    }
+
+    int call_lambda(const int func_hash, const int func_ptr, const EvalFuncStack& arg_values) {
+        // 인자와 매개변수의 개수가 서로 맞지 않을 때
+        int param_count = 0;
+        for (int param = get_lchild(get_rchild(func_ptr)); param != 0; param = get_rchild(param)) {
+            param_count++;
+        }
+        if (param_count != arg_values.size()) {
+            return raise_error(Interpreter::InconsistentArguments(param_count, arg_values.size()));
+        }
+
+        if (--steps_left < 0) {
+            return raise_error(Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+        }
+
+        int jit_result = 0;
+        if (jit_enabled && func_hash != 0 && call_jit_lambda(func_hash, func_ptr, arg_values, jit_result)) {
+            return jit_result;
+        }
+
+        // 인자 계산이 끝난 후 함수 호출에 필요한 포인터 값 삽입 (함수 호출 전의 값은 bindings에 저장)
+        BindingStack& bindings = *dynamic_bindings;
+        const size_t binding_mark = bindings.size();
+        int param = get_lchild(get_rchild(func_ptr));
+        for (int i = 0; i < arg_values.size(); i++) {
+            bind_dynamic(get_lchild(param), arg_values[i].link_of_value);
+            param = get_rchild(param);
+        }
+
+        if (--depth_left < 0) {
+            depth_left++;
+            unbind_dynamic(bindings, binding_mark);
+            return raise_error(Interpreter::LimitExceeded("call depth", eval_limits.max_depth));
+        }
+        if (current_generator != nullptr && current_generator->coroutine.stack_left() < GENERATOR_STACK_MARGIN) {
+            depth_left++;
+            unbind_dynamic(bindings, binding_mark);
+            return raise_error(Interpreter::LimitExceeded("generator stack", SCHEME_GENERATOR_STACK_SIZE));
+        }
+
+        // generator는 다른 흐름과 번갈아 실행되어 region의 순서가 섞이므로 region을 사용하지 않음
+        const bool uses_region = (current_generator == nullptr);
+        if (uses_region && !(region_flags[func_ptr] & REGION_ANALYZED)) {
+            analyze_escapes(func_ptr);
+        }
+        const size_t region_mark = region_cells.size();
+        if (uses_region) {
+            region_depth++;
+        }
+
+        int result = 0;
+        try {
+            result = run_lambda_body(func_hash, func_ptr);
+        } catch (...) {
+            // cell 한도 초과 등으로 계산이 중단되어도 binding은 복원 (region의 cell은 다음 GC가 회수)
+            if (uses_region) {
+                region_depth--;
+                if (region_cells.size() > region_mark) {
+                    region_cells.resize(region_mark);
+                }
+            }
+            unbind_dynamic(bindings, binding_mark);
+            throw;
+        }
+        depth_left++;
+        if (uses_region) {
+            region_depth--;
+            release_region(region_mark);
+        }
+
+        // 함수 호출 전의 포인터 값으로 복원 (오류가 발생한 경우 포함)
+        unbind_dynamic(bindings, binding_mark);
+
+        return result;
+    }
+
+    int run_lambda_body(const int func_hash, const int func_ptr) {
+        // 이름이 없는 lambda는 변환 결과를 저장할 곳이 없으므로 그대로 계산
+        if (execution_mode == ExecutionMode::CLOSURE_COMPILED && func_hash != 0) {
+            const std::shared_ptr<const CompiledExpr> body = get_compiled_lambda(func_hash, func_ptr);
+            return (*body)();
+        }
+
+        return eval(get_lchild(get_rchild(get_rchild(func_ptr))));
+    }
+
+    /* closure compilation
+     * lambda 본문을 처음 호출할 때 한 번만 functor tree로 변환한다.
+     * 각 functor는 연산의 종류, 피연산자 functor, 상수 인자를 미리 잡아 두므로
+     * 호출할 때마다 parse tree를 다시 순회하거나 연산자 문자열을 비교하지 않는다.
+     * 변환할 수 없는 형태는 eval(root)를 그대로 호출하는 functor로 남긴다.
+     */
+    std::shared_ptr<const CompiledExpr> get_compiled_lambda(const int func_hash, const int func_ptr) {
+        compiled_lambda_struct& entry = compiled_lambdas[func_hash];
+        if (entry.lambda_ptr != func_ptr || !entry.body) {
+            entry.lambda_ptr = func_ptr;
+            entry.body = std::make_shared<const CompiledExpr>(compile(get_lchild(get_rchild(get_rchild(func_ptr)))));
+        }
+
+        return entry.body;
+    }
+
+    /* baseline JIT
+     * 호출 횟수가 JIT_CALL_THRESHOLD에 도달한 lambda 중
+     * 매개변수, 숫자 상수, + - * /, < > =, cond, 자기 자신의 재귀 호출만으로 이루어진 본문을 기계어로 변환한다.
+     * 인자가 interpreter 표현 그대로의 숫자가 아니거나 계산 도중 guard가 실패하면
+     * 그 호출은 interpreter가 처음부터 다시 계산한다.
+     */
+    bool call_jit_lambda(const int func_hash, const int func_ptr, const EvalFuncStack& arg_values, int& result) {
+        jit_lambda_struct& entry = jit_lambdas[func_hash];
+        if (entry.lambda_ptr != func_ptr) {
+            entry = jit_lambda_struct();
+            entry.lambda_ptr = func_ptr;
+        }
+
+        if (!entry.code) {
+            if (entry.rejected || ++entry.call_count < JIT_CALL_THRESHOLD) {
+                return false;
+            }
+
+            jit_expr_struct body;
+            std::unique_ptr<JitFunction> code(new JitFunction());
+            if (!build_jit_lambda(func_hash, func_ptr, body) || !JitCompiler().compile(body, *code)) {
+                entry.rejected = true;
+                return false;
+            }
+            entry.code = std::move(code);
+        }
+
+        // guard: 모든 인자가 숫자
+        double args[EvalFuncStack::MAX_PARAMS];
+        for (int i = 0; i < arg_values.size(); i++) {
+            const int value = arg_values[i].link_of_value;
+            if (value >= 0 || !is_canonical_number(value, args[i])) {
+                return false;
+            }
+        }
+
+        // 기계어 함수도 호출될 때마다 계산 단계와 호출 깊이를 하나씩 사용
+        double value = 0.0;
+        JitFunction::fuel() = steps_left;
+        JitFunction::depth_left() = depth_left;
+        if (current_generator != nullptr) {
+            // generator의 stack에서는 남은 공간만큼만 재귀
+            const std::int64_t stack_depth = static_cast<std::int64_t>(current_generator->coroutine.stack_left() / JIT_FRAME_SIZE);
+            if (stack_depth < JitFunction::depth_left()) {
+                JitFunction::depth_left() = stack_depth;
+            }
+        }
+        const int status = entry.code->call(args, &value);
+        steps_left = JitFunction::fuel();
+        if (status != 0) {
+            return false;
+        }
+
+        result = make_number(value);
+        return true;
+    }
+
+    // @param value: symbol의 hash 값.
+    // @param number: value를 double로 변환한 값.
+    // @return value가 계산 결과로 다시 만들어지는 형태(make_number)의 숫자인지의 여부.
+    // (NaN과 -0은 interpreter의 =와 double 비교의 결과가 다르므로 제외)
+    bool is_canonical_number(const int value, double& number) const {
+        if (!hash_table.is_canonical_number(value)) {
+            return false;
+        }
+
+        number = hash_table.get_number(value);
+        return !std::isnan(number) && !(number == 0 && std::signbit(number));
+    }
+
+    bool build_jit_lambda(const int func_hash, const int func_ptr, jit_expr_struct& body) {
+        std::vector<int> params;
+        for (int param = get_lchild(get_rchild(func_ptr)); param != 0; param = get_rchild(param)) {
+            const int param_hash = get_lchild(param);
+            // 함수 이름을 가리는 매개변수나 중복된 매개변수는 변환하지 않음
+            if (param_hash >= 0 || param_hash == func_hash) {
+                return false;
+            }
+            for (const int i : params) {
+                if (i == param_hash) {
+                    return false;
+                }
+            }
+            params.push_back(param_hash);
+        }
+
+        return build_jit_expr(get_lchild(get_rchild(get_rchild(func_ptr))), func_hash, params, body);
+    }
+
+    // 숫자 결과를 내는 식만 변환
+    bool build_jit_expr(const int root, const int func_hash, const std::vector<int>& params, jit_expr_struct& expr) {
+        if (root < 0) { // symbol
+            for (size_t i = 0; i < params.size(); i++) {
+                if (params[i] == root) {
+                    expr.kind = jit_expr_struct::PARAM;
+                    expr.param_index = static_cast<int>(i);
+                    return true;
+                }
+            }
+
+            expr.kind = jit_expr_struct::CONSTANT;
+            return is_canonical_number(root, expr.constant);
+        }
+
+        if (root == 0 || get_lchild(root) >= 0 || node_array.is_object(root)) {
+            return false;
+        }
+
+        const std::string& token_index = hash_table.get_value(get_lchild(root));
+        const int argument = get_rchild(root);
+        const int params_count = count_params(root);
+
+        if (token_index == "+" || token_index == "-" || token_index == "*" || token_index == "/") {
+            if (params_count != 2) {
+                return false;
+            }
+
+            expr.kind = (token_index == "+") ? jit_expr_struct::ADD :
+                        (token_index == "-") ? jit_expr_struct::SUB :
+                        (token_index == "*") ? jit_expr_struct::MUL : jit_expr_struct::DIV;
+            expr.operands.resize(2);
+            return build_jit_expr(get_lchild(argument), func_hash, params, expr.operands[0]) &&
+                   build_jit_expr(get_lchild(get_rchild(argument)), func_hash, params, expr.operands[1]);
+
+        } else if (token_index == "cond") {
+            if (argument == 0) {
+                return false;
+            }
+
+            expr.kind = jit_expr_struct::COND;
+            int clause = argument;
+            for (; get_rchild(clause) != 0; clause = get_rchild(clause)) {
+                expr.operands.push_back(jit_expr_struct());
+                if (!build_jit_test(get_lchild(get_lchild(clause)), func_hash, params, expr.operands.back())) {
+                    return false;
+                }
+
+                expr.operands.push_back(jit_expr_struct());
+                if (!build_jit_expr(get_lchild(get_rchild(get_lchild(clause))), func_hash, params, expr.operands.back())) {
+                    return false;
+                }
+            }
+
+            // 마지막 절은 반드시 else
+            const int else_keyword = get_lchild(get_lchild(clause));
+            if (else_keyword >= 0 || hash_table.get_value(else_keyword) != "else") {
+                return false;
+            }
+
+            expr.operands.push_back(jit_expr_struct());
+            return build_jit_expr(get_lchild(get_rchild(get_lchild(clause))), func_hash, params, expr.operands.back());
+
+        } else if (get_lchild(root) == func_hash) {
+            if (params_count != static_cast<int>(params.size())) {
+                return false;
+            }
+
+            expr.kind = jit_expr_struct::SELF_CALL;
+            expr.operands.resize(params_count);
+            int temp_arg = argument;
+            for (int i = 0; i < params_count; i++) {
+                if (!build_jit_expr(get_lchild(temp_arg), func_hash, params, expr.operands[i])) {
+                    return false;
+                }
+                temp_arg = get_rchild(temp_arg);
+            }
+
+            return true;
+        }
+
+        return false;
+    }
+
+    // cond의 조건: 숫자 비교만 변환
+    bool build_jit_test(const int root, const int func_hash, const std::vector<int>& params, jit_expr_struct& expr) {
+        if (root <= 0 || get_lchild(root) >= 0 || count_params(root) != 2) {
+            return false;
+        }
+
+        const std::string& token_index = hash_table.get_value(get_lchild(root));
+        if (token_index == "<") {
+            expr.kind = jit_expr_struct::LESS;
+        } else if (token_index == ">") {
+            expr.kind = jit_expr_struct::GREATER;
+        } else if (token_index == "=") {
+            expr.kind = jit_expr_struct::EQUAL;
+        } else {
+            return false;
+        }
+
+        const int argument = get_rchild(root);
+        expr.operands.resize(2);
+        return build_jit_expr(get_lchild(argument), func_hash, params, expr.operands[0]) &&
+               build_jit_expr(get_lchild(get_rchild(argument)), func_hash, params, expr.operands[1]);
+    }
+
+    CompiledExpr compile_fallback(const int root) {
+        return [this, root]() { return eval(root); };
+    }
+
+    // eq?, equal?의 피연산자: 값이 정의된 symbol은 그 값으로, 나머지는 그대로 비교
+    CompiledExpr compile_identity_operand(const int operand) {
+        if (operand < 0) {
+            return [this, operand]() {
+                const int value = hash_table.get_pointer(operand);
+                return (value != 0) ? value : operand;
+            };
+        }
+
+        return [operand]() { return operand; };
+    }
+
+    // @param root: 변환할 식의 node 포인터 또는 hash 값.
+    // @return root를 계산하는 functor.
+    CompiledExpr compile(const int root) {
+        if (root == 0) {
+            return []() { return 0; };
+        }
+
+        if (root < 0) { // symbol
+            if (hash_table.is_number(root)) { // symbol is a number
+                return [root]() { return root; };
+            }
+            if (hash_table.get_value(root) == "#t" || hash_table.get_value(root) == "#f") {
+                return [this, root]() { return hash_table.get_pointer(root) != 0 ? hash_table.get_pointer(root) : root; };
+            }
+            return [this, root]() {
+                const int value = hash_table.get_pointer(root);
+                return (value != 0 || library_index.empty()) ? value : load_library_value(root);
+            };
+        }
+
+        if (node_array.is_object(root)) { // 문자열 literal 등
+            return [root]() { return root; };
+        }
+
+        const int head = get_lchild(root);
+        if (head >= 0) {
+            return compile_fallback(root);
+        }
+
+        const std::string token_index = hash_table.get_value(head);
+        const int argument = get_rchild(root);
+        const int params = count_params(root);
+        const int true_hash = hash_table.get_hash_value("#t");
+        const int false_hash = hash_table.get_hash_value("#f");
+
+        if (token_index == "+" || token_index == "-" || token_index == "*" || token_index == "/") {
+            // 인자 개수 오류는 eval()이 처리
+            if (params != 2) {
+                return compile_fallback(root);
+            }
+
+            const CompiledExpr lhs = compile(get_lchild(argument));
+            const CompiledExpr rhs = compile(get_lchild(get_rchild(argument)));
+
+            const char op = token_index[0];
+            return [this, root, lhs, rhs, op]() {
+                const int arg1 = lhs();
+                if (arg1 == EVAL_ERROR) return propagate_error(root);
+                const int arg2 = rhs();
+                if (arg2 == EVAL_ERROR) return propagate_error(root);
+                if (check_number_operand(arg1) == EVAL_ERROR || check_number_operand(arg2) == EVAL_ERROR) {
+                    return propagate_error(root);
+                }
+
+                const double a = to_number(arg1), b = to_number(arg2);
+                switch (op) {
+                case '+': return make_number(a + b);
+                case '-': return make_number(a - b);
+                case '*': return make_number(a * b);
+                default:  return make_number(a / b);
+                }
+            };
+
+        } else if (token_index == "=" || token_index == "<" || token_index == ">") {
+            if (params != 2) {
+                return compile_fallback(root);
+            }
+
+            const CompiledExpr lhs = compile(get_lchild(argument));
+            const CompiledExpr rhs = compile(get_lchild(get_rchild(argument)));
+
+            if (token_index == "=") {
+                return [this, root, lhs, rhs, true_hash, false_hash]() {
+                    const int arg1 = lhs();
+                    if (arg1 == EVAL_ERROR) return propagate_error(root);
+                    const int arg2 = rhs();
+                    if (arg2 == EVAL_ERROR) return propagate_error(root);
+
+                    if (check_number_operand(arg1) == EVAL_ERROR || check_number_operand(arg2) == EVAL_ERROR) {
+                        return propagate_error(root);
+                    }
+                    return (arg1 == arg2) ? true_hash : false_hash;
+                };
+            }
+
+            const bool is_less = (token_index == "<");
+            return [this, root, lhs, rhs, is_less, true_hash, false_hash]() {
+                const int arg1 = lhs();
+                if (arg1 == EVAL_ERROR) return propagate_error(root);
+                if (check_number_operand(arg1) == EVAL_ERROR) return propagate_error(root);
+                const int arg2 = rhs();
+                if (arg2 == EVAL_ERROR) return propagate_error(root);
+                if (check_number_operand(arg2) == EVAL_ERROR) return propagate_error(root);
+
+                const double a = to_number(arg1), b = to_number(arg2);
+                return (is_less ? a < b : a > b) ? true_hash : false_hash;
+            };
+
+        } else if (token_index == "eq?" || token_index == "equal?") {
+            if (params != 2) {
+                return compile_fallback(root);
+            }
+
+            const CompiledExpr lhs = compile_identity_operand(get_lchild(argument));
+            const CompiledExpr rhs = compile_identity_operand(get_lchild(get_rchild(argument)));
+
+            if (token_index == "eq?") {
+                return [lhs, rhs, true_hash, false_hash]() {
+                    return (lhs() == rhs()) ? true_hash : false_hash;
+                };
+            }
+            return [this, lhs, rhs, true_hash, false_hash]() {
+                return is_equal_structure(lhs(), rhs()) ? true_hash : false_hash;
+            };
+
+        } else if (token_index == "number?" || token_index == "null?" || token_index == "car" || token_index == "cdr" ||
+                   token_index == "print" || token_index == "display") {
+            if (params != 1) {
+                return compile_fallback(root);
+            }
+
+            const CompiledExpr arg = compile(get_lchild(argument));
+
+            if (token_index == "number?") {
+                return [this, root, arg, true_hash, false_hash]() {
+                    const int value = arg();
+                    if (value == EVAL_ERROR) return propagate_error(root);
+                    return (value < 0 && hash_table.is_number(value)) ? true_hash : false_hash;
+                };
+            } else if (token_index == "null?") {
+                return [this, root, arg, true_hash, false_hash]() {
+                    const int value = arg();
+                    if (value == EVAL_ERROR) return propagate_error(root);
+                    return (value == 0) ? true_hash : false_hash;
+                };
+            } else if (token_index == "car") {
+                return [this, root, arg]() {
+                    const int value = arg();
+                    return (value == EVAL_ERROR) ? propagate_error(root) : get_lchild(value);
+                };
+            } else if (token_index == "cdr") {
+                return [this, root, arg]() {
+                    const int value = arg();
+                    return (value == EVAL_ERROR) ? propagate_error(root) : get_rchild(value);
+                };
+            }
+            return arg; // print, display
+
+        } else if (token_index == "cons") {
+            if (params != 2) {
+                return compile_fallback(root);
+            }
+
+            const CompiledExpr lhs = compile(get_lchild(argument));
+            const CompiledExpr rhs = compile(get_lchild(get_rchild(argument)));
+
+            return [this, root, lhs, rhs]() {
+                int temp_ptr = alloc_cons(root);
+                const int head = lhs();
+                if (head == EVAL_ERROR) return propagate_error(root);
+                const int tail = rhs();
+                if (tail == EVAL_ERROR) return propagate_error(root);
+
+                node_array.set_head(temp_ptr, head);
+                node_array.set_tail(temp_ptr, tail);
+                return temp_ptr;
+            };
+
+        } else if (token_index == "quote") {
+            if (params != 1) {
+                return compile_fallback(root);
+            }
+
+            const int quoted = get_lchild(argument);
+            return [quoted]() { return quoted; };
+
+        } else if (token_index == "cond") {
+            // 마지막 절이 else가 아닌 경우의 오류는 eval()이 처리
+            if (argument == 0) {
+                return compile_fallback(root);
+            }
+
+            std::vector<CompiledExpr> tests;
+            std::vector<CompiledExpr> bodies;
+            int clause = argument;
+            for (; get_rchild(clause) != 0; clause = get_rchild(clause)) {
+                tests.push_back(compile(get_lchild(get_lchild(clause))));
+                bodies.push_back(compile(get_lchild(get_rchild(get_lchild(clause)))));
+            }
+
+            const int else_keyword = get_lchild(get_lchild(clause));
+            if (else_keyword >= 0 || hash_table.get_value(else_keyword) != "else") {
+                return compile_fallback(root);
+            }
+            const CompiledExpr else_body = compile(get_lchild(get_rchild(get_lchild(clause))));
+
+            return [this, root, tests, bodies, else_body, true_hash, false_hash]() {
+                for (size_t i = 0; i < tests.size(); i++) {
+                    const int test = tests[i]();
+                    if (test == EVAL_ERROR) return propagate_error(root);
+                    if (test != true_hash && test != false_hash) {
+                        return raise_error(root, Interpreter::WrongTypeError("a boolean", get_output_string(test)));
+                    }
+                    if (test == true_hash) {
+                        const int result = bodies[i]();
+                        return (result == EVAL_ERROR) ? propagate_error(root) : result;
+                    }
+                }
+                const int result = else_body();
+                return (result == EVAL_ERROR) ? propagate_error(root) : result;
+            };
+
+        } else if (token_index == "lambda") {
+            return [root]() { return root; };
+
+        } else if (token_index == "begin") {
+            std::vector<CompiledExpr> exprs;
+            for (int temp_arg = argument; temp_arg != 0; temp_arg = get_rchild(temp_arg)) {
+                exprs.push_back(compile(get_lchild(temp_arg)));
+            }
+
+            return [this, root, exprs]() {
+                int result = 0;
+                for (const CompiledExpr& expr : exprs) {
+                    result = expr();
+                    if (result == EVAL_ERROR) return propagate_error(root);
+                }
+                return result;
+            };
+
+        } else if (token_index == "%" || token_index == "symbol?" || token_index == "define" ||
+                   token_index == HashTable::symbol_name("define-syntax") || token_index == "delay" ||
+                   token_index == HashTable::symbol_name("define-record-type") ||
+                   token_index == HashTable::symbol_name("cons-stream") || token_index == "let" ||
+                   token_index == "let*" || token_index == "do") {
+            return compile_fallback(root);
+        }
+
+        // 사용자 정의 function
+        std::vector<CompiledExpr> args;
+        for (int temp_arg = argument; temp_arg != 0; temp_arg = get_rchild(temp_arg)) {
+            args.push_back(compile(get_lchild(temp_arg)));
+        }
+
+        return [this, root, head, args]() {
+            // 정의되지 않은 함수, lambda가 아닌 값의 오류는 eval()이 처리
+            const int func_ptr = hash_table.get_pointer(head);
+            if (!is_lambda(func_ptr)) {
+                return eval(root);
+            }
+
+            EvalFuncStack temp_arg_stack;
+            for (const CompiledExpr& arg : args) {
+                const int value = arg();
+                if (value == EVAL_ERROR) return propagate_error(root);
+                temp_arg_stack.push(0, value);
+            }
+
+            const int result = apply_lambda(head, func_ptr, temp_arg_stack);
+            if (result == EVAL_ERROR) return propagate_error(root);
+            return result;
+        };
+    }
+
+    public:
+    // @param input: 명령어 문자열.
+    // @return 명령어가 전부 입력되었는지의 여부.
+    bool read(const std::string& input) {
+        int orig_read_number_of_left_paren = read_number_of_left_paren;
+        const bool orig_read_in_string = read_in_string, orig_read_escaped = read_escaped;
+        std::string orig_input_str = input_str;
+
+        try {
+            // 괄호 개수 확인 -> 명령어가 전부 입력되었는지 확인
+            for (const char i : input) {
+                input_str += i;
+                if (read_in_string) { // 문자열 literal 안
+                    if (read_escaped) {
+                        read_escaped = false;
+                    } else if (i == '\\') {
+                        read_escaped = true;
+                    } else if (i == '"') {
+                        read_in_string = false;
+                    }
+                } else if (i == '"') {
+                    read_in_string = true;
+                } else if (i == '(') {
+                    read_number_of_left_paren++;
+                } else if (i == ')') {
+                    read_number_of_left_paren--;
+
+                    // 완전한 형태의 명령이 들어올 때마다 read 및 macro 전개
+                    if (read_number_of_left_paren == 0) {
+                        parse_input();
+                    }
+                }
+            }
+
+            // 명령어가 전부 입력되지 않음
+            if (read_number_of_left_paren != 0 || read_in_string) {
+                return false;
+            }
+
+            // 괄호로 끝나지 않는 명령 (symbol, 'symbol)
+            if (input_str.find_first_not_of(' ') != std::string::npos) {
+                parse_input();
+            }
+
+            return true;
+        } catch (Interpreter::GarbageCollectionPerformed& e) {
+            // GC 횟수가 2회 이상
+            if (garbage_collection_count > 1) {
+                garbage_collection_count = 0;
+                read_number_of_left_paren = orig_read_number_of_left_paren;
+                read_in_string = orig_read_in_string;
+                read_escaped = orig_read_escaped;
+                input_str = orig_input_str;
+                throw std::length_error("Size of the node array is too small: " + std::to_string(NodeArray::NODE_ARRAY_SIZE));
+            }
+
+            read_number_of_left_paren = orig_read_number_of_left_paren;
+            read_in_string = orig_read_in_string;
+            read_escaped = orig_read_escaped;
+            input_str = orig_input_str;
+
+            bool result = read(input);
+            garbage_collection_count = 0;
+            return result;
+        } catch (Interpreter::ParseArenaFull& e) {
+            read_number_of_left_paren = orig_read_number_of_left_paren;
+            read_in_string = orig_read_in_string;
+            read_escaped = orig_read_escaped;
+            input_str = orig_input_str;
+
+            // arena보다 큰 명령은 main heap에 읽음
+            parse_into_main_heap = true;
+            bool result = false;
+            try {
+                result = read(input);
+            } catch (...) {
+                parse_into_main_heap = false;
+                throw;
+            }
+            parse_into_main_heap = false;
+            return result;
+        }
+    }
+
+    // @param elements: list의 원소.
+    // @return 새로 만든 list의 root node 포인터.
+    int make_list(const std::vector<int>& elements) {
+        int root_ptr = 0, temp_ptr = 0;
+        for (const int element : elements) {
+            const int new_ptr = parse_alloc();
+            node_array.set_head(new_ptr, element);
+            node_array.set_tail(new_ptr, 0);
+
+            if (root_ptr == 0) {
+                root_ptr = new_ptr;
+            } else {
+                node_array.set_tail(temp_ptr, new_ptr);
+            }
+            temp_ptr = new_ptr;
+        }
+
+        return root_ptr;
+    }
+
+    // @param elements: list의 원소.
+    // @return 뒤에서부터 hash-consing하여 만든 list의 root node 포인터.
+    int make_hash_consed_list(const std::vector<int>& elements) {
+        int root_ptr = 0;
+        for (auto iter = elements.rbegin(); iter != elements.rend(); iter++) {
+            root_ptr = hash_cons(*iter, root_ptr);
+        }
+
+        return root_ptr;
+    }
+
+    // 문자열 literal이 아래의 read(bool)로 변환되지 않도록 함
+    bool read(const char* input) {
+        return read(std::string(input));
+    }
+
+    // @param is_quoted: quote된 data를 읽는 중인지의 여부.
+    int read(const bool is_quoted = false) {
+        std::string token_value = get_next_token();
+
+        if (token_value == "_END_OF_LINE") {
+            return 0;
+        } else if (token_value == "(") {
+            // 원소를 모두 읽은 뒤 list의 node를 한 번에 할당하여 연속된 index에 둠
+            const int quote_hash = hash_table.get_hash_value("quote");
+            std::vector<int> elements;
+            while (token_value = get_next_token(), token_value != ")") {
+                // (quote datum)의 datum
+                const bool is_quoted_element = is_quoted || (elements.size() == 1 && elements[0] == quote_hash);
+
+                if (token_value == "(" || token_value == "'") {
+                    input_str_read_ptr--;
+                    elements.push_back(read(is_quoted_element));
+                } else {
+                    elements.push_back(read_atom(token_value, is_quoted_element));
+                }
+            }
+
+            if (is_quoted && hash_consing_enabled) {
+                return make_hash_consed_list(elements);
+            }
+            return make_list(elements);
+        } else if (token_value == "'") {
+            // 'datum => (quote datum)
+            std::vector<int> elements;
+            elements.push_back(hash_table.get_hash_value("quote"));
+            elements.push_back(read(true));
+
+            if (is_quoted && hash_consing_enabled) {
+                return make_hash_consed_list(elements);
+            }
+            return make_list(elements);
+        } else {
+            return read_atom(token_value, is_quoted);
+        }
+    }
+
+    // @param is_quoted: quote된 data 안의 atom인지의 여부. (hash-consing 중이면 내용이 같은 문자열 literal은 같은 object)
+    // @return token이 문자열 literal이면 문자열 object, 아니면 symbol의 hash 값.
+    int read_atom(const std::string& token, const bool is_quoted = false) {
+        if (!token.empty() && token[0] == '"') {
+            const std::string value = StringObject::unescape(token);
+            if (!is_quoted || !hash_consing_enabled) {
+                return make_object(new StringObject(value));
+            }
+
+            const std::unordered_map<std::string, int>::const_iterator found = hash_consed_strings.find(value);
+            if (found != hash_consed_strings.end()) {
+                return found->second;
+            }
+            const int string_ptr = make_object(new StringObject(value));
+            hash_consed_strings[value] = string_ptr;
+            return string_ptr;
+        }
+
+        return hash_table.get_hash_value(token);
+    }
+
+    void eval() {
+        std::string output = "";
+        if (eval(output)) {
+            std::cout << output << "\n\n";
+        } else {
+            std::cerr << output;
+        }
+    }
+
+    // @param output: 계산 결과 또는 오류 메시지를 저장할 곳.
+    // @return 오류 없이 계산했는지의 여부.
+    bool eval(std::string& output) {
+        const int result = run_command([this]() { return eval(parse_tree_root_ptr); });
+        if (result == EVAL_ERROR) {
+            output = format_error(pending_error);
+            return false;
+        }
+
+        if (result == 0) {
+            output = "()";
+        } else if (result < 0) {
+            // hash
+            output = hash_table.get_value(result);
+        } else { // if (result > 0)
+            // node pointer
+            output = "";
+            get_output(result, true, output);
+        }
+
+        return true;
+    }
+
+    private:
+    // @param command: 최상위 명령 하나를 계산하는 함수.
+    // @return 계산 결과. 중단되거나 오류가 발생하면 pending_error를 기록하고 EVAL_ERROR.
+    int run_command(const std::function<int()>& command) {
+        int result = 0;
+        start_eval_budget();
+        if (tracer.is_enabled()) {
+            tracer.begin("eval", "command");
+        }
+        try {
+            result = command();
+        } catch (const Interpreter::InterpreterError& error) { // cell 한도 초과
+            pending_error = error;
+            result = EVAL_ERROR;
+        } catch (const Interpreter::GarbageCollectionPerformed&) {
+            // 계산 중인 식은 GC root가 아니므로 이어서 계산할 수 없음
+            garbage_collection_count = 0;
+            pending_error = Interpreter::OutOfMemory("garbage collection was needed during evaluation");
+            result = EVAL_ERROR;
+        } catch (const std::range_error& e) { // 검사하지 않은 cell을 symbol로 읽음
+            pending_error = Interpreter::InvalidOperand(e.what());
+            result = EVAL_ERROR;
+        } catch (const std::length_error& e) { // node array, hash table이 가득 참
+            garbage_collection_count = 0;
+            pending_error = Interpreter::OutOfMemory(e.what());
+            result = EVAL_ERROR;
+            // 중단된 계산이 만든 숫자 symbol을 회수해야 다음 명령을 읽을 수 있음
+            collect_garbage();
+        }
+        if (tracer.is_enabled()) {
+            tracer.end("eval");
+        }
+        end_eval_budget();
+
+        return result;
+    }
+
+    public:
+    // 입력 중이던 명령어를 버림
+    void reset_reader() {
+        read_number_of_left_paren = 0;
+        read_in_string = false;
+        read_escaped = false;
+        input_str = "";
+    }
+
+    // @param root: 오류가 발생했을 때 eval stack에 남길 식.
+    // @param func_ptr: 호출할 함수의 값.
+    // @param arg_values: 계산이 끝난 인자 값.
+    // @return 함수 본문의 결과 해시 값 또는 node 포인터. 오류가 발생하면 EVAL_ERROR.
+    int apply_procedure(const int root, const int func_ptr, const EvalFuncStack& arg_values) {
+        if (!is_lambda(func_ptr)) {
+            if (is_applicable_object(func_ptr)) {
+                return apply_object(root, func_ptr, arg_values);
+            }
+            return raise_error(root, Interpreter::NotProcedure(get_output_string(func_ptr)));
+        }
+
+        const int result = apply_lambda(0, func_ptr, arg_values);
+        if (result == EVAL_ERROR) return propagate_error(root);
+        return result;
+    }
+
+    /* procedure 인자로 넘긴 기본 함수 (fold +, fold-right cons, map car 등)
+     * 기본 함수는 값이 아니므로 인자 식의 이름으로 확인하고
+     * 계산이 끝난 인자 값에 바로 적용한다. 다시 정의된 이름은 보통의 값으로 계산한다.
+     */
+
+    // @param name: 기본 함수 이름.
+    // @return 인자로 넘길 수 있는 기본 함수인지의 여부.
+    static bool is_callback_builtin(const std::string& name) {
+        return name == "+" || name == "-" || name == "*" || name == "/" || name == "=" || name == "<" ||
+               name == ">" || name == "cons" || name == "car" || name == "cdr" || name == "null?" ||
+               name == "number?" || name == "eq?" || name == "equal?";
+    }
+
+    // @param expr: procedure 인자 식.
+    // @param builtin: expr가 기본 함수 이름이면 그 hash 값, 아니면 0을 기록.
+    // @return expr의 값. (기본 함수이면 0) 오류가 발생하면 EVAL_ERROR.
+    int eval_procedure(const int expr, int& builtin) {
+        builtin = 0;
+        if (expr >= 0 || hash_table.get_pointer(expr) != 0 || hash_table.is_number(expr)) {
+            return eval(expr);
+        }
+
+        const std::string name = hash_table.get_value(expr);
+        if (library_index.find(name) != nullptr) {
+            return eval(expr); // require한 library의 함수: 처음 넘길 때 정의를 읽음
+        }
+        if (!is_callback_builtin(name)) {
+            return raise_error(Interpreter::BuiltinNotProcedure(name));
+        }
+
+        builtin = expr;
+        return 0;
+    }
+
+    // @param builtin: eval_procedure()가 기록한 기본 함수의 hash 값. (0이면 procedure를 호출)
+    // @return apply_procedure()와 같음.
+    int apply_callback(const int root, const int builtin, const int procedure, const EvalFuncStack& arg_values) {
+        if (builtin == 0) {
+            return apply_procedure(root, procedure, arg_values);
+        }
+
+        const std::string name = hash_table.get_value(builtin);
+        const int params = arg_values.size();
+        const bool is_unary = (name == "car" || name == "cdr" || name == "null?" || name == "number?");
+        if (params != (is_unary ? 1 : 2)) {
+            return raise_error(root, Interpreter::InconsistentArguments(is_unary ? 1 : 2, params));
+        }
+
+        const int arg1 = arg_values[0].link_of_value;
+        const int arg2 = is_unary ? 0 : arg_values[1].link_of_value;
+        const int true_hash = hash_table.get_hash_value("#t");
+        const int false_hash = hash_table.get_hash_value("#f");
+
+        if (name == "car") {
+            return get_lchild(arg1);
+        } else if (name == "cdr") {
+            return get_rchild(arg1);
+        } else if (name == "null?") {
+            return (arg1 == 0) ? true_hash : false_hash;
+        } else if (name == "number?") {
+            return (arg1 < 0 && hash_table.is_number(arg1)) ? true_hash : false_hash;
+        } else if (name == "cons") {
+            const int cell = node_array_alloc();
+            node_array.set_head(cell, arg1);
+            node_array.set_tail(cell, arg2);
+            return cell;
+        } else if (name == "eq?") {
+            return (arg1 == arg2) ? true_hash : false_hash;
+        } else if (name == "equal?") {
+            return is_equal_structure(arg1, arg2) ? true_hash : false_hash;
+        }
+
+        if (check_number_operand(arg1) == EVAL_ERROR || check_number_operand(arg2) == EVAL_ERROR) {
+            return propagate_error(root);
+        }
+        switch (name[0]) {
+        case '+':
+            return make_number(to_number(arg1) + to_number(arg2));
+        case '-':
+            return make_number(to_number(arg1) - to_number(arg2));
+        case '*':
+            return make_number(to_number(arg1) * to_number(arg2));
+        case '/':
+            return make_number(to_number(arg1) / to_number(arg2));
+        case '=':
+            return (arg1 == arg2) ? true_hash : false_hash;
+        case '<':
+            return (to_number(arg1) < to_number(arg2)) ? true_hash : false_hash;
+        default:
+            return (to_number(arg1) > to_number(arg2)) ? true_hash : false_hash;
+        }
+    }
+
+    // @param root: 함수 호출 식.
+    // @param func_hash: 호출할 함수 이름의 hash 값. (이름이 없는 lambda: 0)
+    // @param func_ptr: 호출할 함수의 값.
+    // @return 함수 본문의 결과 해시 값 또는 node 포인터. 오류가 발생하면 EVAL_ERROR.
+    int call_procedure(const int root, const int func_hash, const int func_ptr) {
+        if (!is_lambda(func_ptr) && !is_applicable_object(func_ptr)) {
+            return raise_error(root, Interpreter::NotProcedure(get_output_string(get_lchild(root))));
+        }
+
+        const RecordProcedure* record_procedure = dynamic_cast<const RecordProcedure*>(get_object(func_ptr));
+        if (record_procedure != nullptr) {
+            std::vector<int> values;
+            const ValueScope value_scope(current_generator, values);
+            for (int argument = get_rchild(root); argument != 0; argument = get_rchild(argument)) {
+                const int arg = eval(get_lchild(argument));
+                if (arg == EVAL_ERROR) return propagate_error(root);
+                values.push_back(arg);
+            }
+            return apply_record_procedure(root, record_procedure, values);
+        }
+
+        EvalFuncStack temp_arg_stack; // 인자(argument)로 넣을 값을 임시로 저장(모든 인자 계산이 끝나기 전까지 hash table을 건드리면 안 됨)
+
+        int argument = get_rchild(root);
+        while (argument != 0) {
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            temp_arg_stack.push(0, arg);
+            argument = get_rchild(argument);
+        }
+
+        if (!is_lambda(func_ptr)) {
+            return apply_object(root, func_ptr, temp_arg_stack);
+        }
+        const int result = apply_lambda(func_hash, func_ptr, temp_arg_stack);
+        if (result == EVAL_ERROR) return propagate_error(root);
+        return result;
+    }
+
+    /* let, let*, named let, do
+     * 변수는 apply_lambda처럼 hash table에 직접 묶고 끝나면 복원한다.
+     * named let 본문의 꼬리 위치(cond의 절, begin의 마지막 식)에서 자기 자신을 호출하거나 do가 반복할 때는
+     * 함수를 다시 호출하지 않고 같은 binding 자리에 새 값을 넣은 뒤 C++ 반복문으로 되돌아간다.
+     */
+
+    // @return (var expr ...) 형태인지의 여부.
+    bool is_binding_clause(const int clause) const {
+        return clause > 0 && !node_array.is_object(clause) && get_lchild(clause) < 0 && get_rchild(clause) > 0;
+    }
+
+    // @param root: (let ...) 또는 (let* ...) 식.
+    // @param is_sequential: let*이면 true. (앞의 변수를 묶은 뒤 다음 초기값을 계산)
+    int eval_let(const int root, const bool is_sequential) {
+        int argument = get_rchild(root);
+        if (!is_sequential && argument > 0 && get_lchild(argument) < 0) {
+            return eval_named_let(root, get_lchild(argument), get_rchild(argument));
+        }
+
+        if (argument <= 0 || get_lchild(argument) < 0 || node_array.is_object(get_lchild(argument)) || get_rchild(argument) == 0) {
+            return raise_error(root, Interpreter::BadSyntax(hash_table.get_value(get_lchild(root))));
+        }
+
+        BindingScope scope(hash_table, *dynamic_bindings);
+        std::vector<int> vars, values;
+        const ValueScope value_scope(current_generator, values);
+        for (int clause = get_lchild(argument); clause != 0; clause = get_rchild(clause)) {
+            const int binding = get_lchild(clause);
+            if (!is_binding_clause(binding)) {
+                return raise_error(root, Interpreter::BadSyntax(hash_table.get_value(get_lchild(root))));
+            }
+
+            const int value = eval(get_lchild(get_rchild(binding)));
+            if (value == EVAL_ERROR) return propagate_error(root);
+
+            if (is_sequential) {
+                scope.bind(get_lchild(binding), value);
+            } else {
+                vars.push_back(get_lchild(binding));
+                values.push_back(value);
+            }
+        }
+
+        // let: 모든 초기값을 계산한 뒤에 묶음
+        for (size_t i = 0; i < vars.size(); i++) {
+            scope.bind(vars[i], values[i]);
+        }
+
+        int result = 0;
+        for (int body = get_rchild(argument); body != 0; body = get_rchild(body)) {
+            result = eval(get_lchild(body));
+            if (result == EVAL_ERROR) return propagate_error(root);
+        }
+
+        return result;
+    }
+
+    // named let의 lambda: 함수 안의 named let은 들어갈 때마다 cell을 할당하지 않도록 parse tree의 자리마다 한 번만 만듦
+    // (key: main heap에 있는 ((var init) ...) body ... node, GC root이며 key가 회수되면 지움)
+    std::unordered_map<int, int> loop_lambdas;
+
+    // @param vars: 매개변수 symbol의 hash 값.
+    // @param body: 본문 식의 list.
+    // @return (lambda (vars ...) body) 또는 (lambda (vars ...) (begin body ...)).
+    int make_loop_lambda(const std::vector<int>& vars, const int body) {
+        int params_ptr = 0;
+        for (auto iter = vars.rbegin(); iter != vars.rend(); iter++) {
+            const int temp_ptr = node_array_alloc();
+            node_array.set_head(temp_ptr, *iter);
+            node_array.set_tail(temp_ptr, params_ptr);
+            params_ptr = temp_ptr;
+        }
+
+        int body_expr = get_lchild(body);
+        if (get_rchild(body) != 0) {
+            body_expr = node_array_alloc();
+            node_array.set_head(body_expr, hash_table.get_hash_value("begin"));
+            node_array.set_tail(body_expr, body);
+        }
+
+        const int body_ptr = node_array_alloc();
+        node_array.set_head(body_ptr, body_expr);
+        node_array.set_tail(body_ptr, 0);
+
+        const int params_link_ptr = node_array_alloc();
+        node_array.set_head(params_link_ptr, params_ptr);
+        node_array.set_tail(params_link_ptr, body_ptr);
+
+        const int lambda_ptr = node_array_alloc();
+        node_array.set_head(lambda_ptr, hash_table.get_hash_value("lambda"));
+        node_array.set_tail(lambda_ptr, params_link_ptr);
+        return lambda_ptr;
+    }
+
+    // (let name ((var init) ...) body ...)
+    // @param name: loop 이름의 hash 값.
+    // @param argument: ((var init) ...) body ...
+    int eval_named_let(const int root, const int name, const int argument) {
+        if (argument <= 0 || get_lchild(argument) < 0 || node_array.is_object(get_lchild(argument)) || get_rchild(argument) == 0) {
+            return raise_error(root, Interpreter::BadSyntax("let"));
+        }
+
+        // 초기값은 이름과 변수를 묶기 전에 계산
+        const unsigned long long loop_serial = hash_table.get_serial();
+        std::vector<int> vars, values;
+        const ValueScope value_scope(current_generator, values);
+        for (int clause = get_lchild(argument); clause != 0; clause = get_rchild(clause)) {
+            const int binding = get_lchild(clause);
+            if (!is_binding_clause(binding)) {
+                return raise_error(root, Interpreter::BadSyntax("let"));
+            }
+
+            const int value = eval(get_lchild(get_rchild(binding)));
+            if (value == EVAL_ERROR) return propagate_error(root);
+            vars.push_back(get_lchild(binding));
+            values.push_back(value);
+        }
+
+        // 꼬리 위치가 아닌 호출, 본문 밖으로 넘긴 경우 등은 일반 함수로 호출
+        const int body = promote(get_rchild(argument)); // 반복마다 계산하는 quote 등을 한 번만 복사
+        int loop_ptr = 0;
+        if (node_array.is_arena(argument)) {
+            loop_ptr = make_loop_lambda(vars, body);
+        } else {
+            const std::unordered_map<int, int>::const_iterator cached = loop_lambdas.find(argument);
+            loop_ptr = (cached != loop_lambdas.end()) ? cached->second : make_loop_lambda(vars, body);
+            loop_lambdas[argument] = loop_ptr;
+        }
+
+        int result = 0;
+        {
+            BindingScope scope(hash_table, *dynamic_bindings);
+            scope.bind(name, loop_ptr);
+            for (size_t i = 0; i < vars.size(); i++) {
+                scope.bind(vars[i], values[i]); // 자리 번호: i + 1
+            }
+
+            std::vector<int> next_values;
+            const ValueScope next_scope(current_generator, next_values);
+            while (true) {
+                bool is_loop = false;
+                result = eval_loop_body(body, name, loop_ptr, next_values, is_loop);
+                if (result == EVAL_ERROR || !is_loop) break;
+
+                if (--steps_left < 0) {
+                    result = raise_error(Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+                    break;
+                }
+                for (size_t i = 0; i < vars.size(); i++) {
+                    scope.set(i + 1, next_values[i]);
+                }
+                reclaim_loop_numbers(loop_serial); // 이전 반복의 값은 더 이상 묶여 있지 않음
+            }
+        }
+
+        // 이 loop의 lambda로 변환해 둔 결과는 더 이상 쓰이지 않음
+        if (compiled_lambdas.count(name) != 0 && compiled_lambdas[name].lambda_ptr == loop_ptr) {
+            compiled_lambdas.erase(name);
+        }
+        if (jit_lambdas.count(name) != 0 && jit_lambdas[name].lambda_ptr == loop_ptr) {
+            jit_lambdas.erase(name);
+        }
+
+        if (result == EVAL_ERROR) return propagate_error(root);
+        return result;
+    }
+
+    // @param body: 본문 식의 list. 마지막 식은 꼬리 위치로 계산
+    // @param next_values: 꼬리 위치에서 loop를 호출했을 때 다음 반복의 인자를 저장할 곳.
+    // @param is_loop: 꼬리 위치에서 loop를 호출했는지의 여부를 저장할 곳.
+    // @return 본문의 결과. (is_loop이면 의미 없음) 오류가 발생하면 EVAL_ERROR.
+    int eval_loop_body(const int body, const int name, const int loop_ptr, std::vector<int>& next_values, bool& is_loop) {
+        int expr = body;
+        for (; get_rchild(expr) != 0; expr = get_rchild(expr)) {
+            if (eval(get_lchild(expr)) == EVAL_ERROR) return EVAL_ERROR;
+        }
+        expr = get_lchild(expr);
+
+        const int true_hash = hash_table.get_hash_value("#t");
+        while (true) {
+            if (expr <= 0 || node_array.is_object(expr) || get_lchild(expr) >= 0) {
+                return eval(expr);
+            }
+
+            const int head = get_lchild(expr);
+            if (head == name && hash_table.get_pointer(name) == loop_ptr) {
+                // (name arg ...): 인자를 모두 계산한 뒤 같은 자리에 다시 묶음
+                next_values.clear();
+                for (int argument = get_rchild(expr); argument != 0; argument = get_rchild(argument)) {
+                    const int value = eval(get_lchild(argument));
+                    if (value == EVAL_ERROR) return propagate_error(expr);
+                    next_values.push_back(value);
+                }
+
+                int param_count = 0;
+                for (int param = get_lchild(get_rchild(loop_ptr)); param != 0; param = get_rchild(param)) {
+                    param_count++;
+                }
+                if (static_cast<int>(next_values.size()) != param_count) {
+                    return raise_error(expr, Interpreter::InconsistentArguments(param_count, next_values.size()));
+                }
+
+                is_loop = true;
+                return 0;
+            }
+
+            const std::string& token_index = hash_table.get_value(head);
+            if (token_index == "cond" && get_rchild(expr) != 0) {
+                if (--steps_left < 0) {
+                    return raise_error(expr, Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+                }
+
+                int clause = get_rchild(expr);
+                for (; get_rchild(clause) != 0; clause = get_rchild(clause)) {
+                    const int test = eval(get_lchild(get_lchild(clause)));
+                    if (test == EVAL_ERROR) return propagate_error(expr);
+                    if (test == true_hash) break;
+                }
+
+                if (get_rchild(clause) == 0) {
+                    // 마지막 절은 반드시 else
+                    const int else_keyword = get_lchild(get_lchild(clause));
+                    if (else_keyword >= 0 || hash_table.get_value(else_keyword) != "else") {
+                        return raise_error(expr, Interpreter::MissingElseClause());
+                    }
+                }
+                expr = get_lchild(get_rchild(get_lchild(clause)));
+
+            } else if (token_index == "begin" && get_rchild(expr) != 0) {
+                if (--steps_left < 0) {
+                    return raise_error(expr, Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+                }
+
+                int argument = get_rchild(expr);
+                for (; get_rchild(argument) != 0; argument = get_rchild(argument)) {
+                    if (eval(get_lchild(argument)) == EVAL_ERROR) return propagate_error(expr);
+                }
+                expr = get_lchild(argument);
+
+            } else {
+                return eval(expr);
+            }
+        }
+    }
+
+    // (do ((var init step) ...) (test expr ...) body ...)
+    int eval_do(const int root) {
+        const int argument = get_rchild(promote(root)); // 반복마다 계산하는 quote 등을 한 번만 복사
+        if (argument <= 0 || get_lchild(argument) < 0 || node_array.is_object(get_lchild(argument)) ||
+            get_rchild(argument) == 0 || get_lchild(get_rchild(argument)) <= 0 ||
+            node_array.is_object(get_lchild(get_rchild(argument)))) {
+            return raise_error(root, Interpreter::BadSyntax("do"));
+        }
+        const int exit_clause = get_lchild(get_rchild(argument));
+        const int body = get_rchild(get_rchild(argument));
+
+        const unsigned long long loop_serial = hash_table.get_serial();
+        std::vector<int> vars, values, steps; // steps: (step) list의 node 포인터. step이 없으면 0
+        const ValueScope value_scope(current_generator, values);
+        for (int clause = get_lchild(argument); clause != 0; clause = get_rchild(clause)) {
+            const int spec = get_lchild(clause);
+            if (!is_binding_clause(spec)) {
+                return raise_error(root, Interpreter::BadSyntax("do"));
+            }
+
+            const int value = eval(get_lchild(get_rchild(spec)));
+            if (value == EVAL_ERROR) return propagate_error(root);
+            vars.push_back(get_lchild(spec));
+            values.push_back(value);
+            steps.push_back(get_rchild(get_rchild(spec)));
+        }
+
+        BindingScope scope(hash_table, *dynamic_bindings);
+        for (size_t i = 0; i < vars.size(); i++) {
+            scope.bind(vars[i], values[i]);
+        }
+
+        const int true_hash = hash_table.get_hash_value("#t");
+        while (true) {
+            if (--steps_left < 0) {
+                return raise_error(root, Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+            }
+
+            const int test = eval(get_lchild(exit_clause));
+            if (test == EVAL_ERROR) return propagate_error(root);
+            if (test == true_hash) {
+                int result = 0;
+                for (int expr = get_rchild(exit_clause); expr != 0; expr = get_rchild(expr)) {
+                    result = eval(get_lchild(expr));
+                    if (result == EVAL_ERROR) return propagate_error(root);
+                }
+                return result;
+            }
+
+            for (int expr = body; expr != 0; expr = get_rchild(expr)) {
+                if (eval(get_lchild(expr)) == EVAL_ERROR) return propagate_error(root);
+            }
+
+            // 모든 step을 계산한 뒤에 묶음
+            for (size_t i = 0; i < vars.size(); i++) {
+                if (steps[i] == 0) continue;
+
+                values[i] = eval(get_lchild(steps[i]));
+                if (values[i] == EVAL_ERROR) return propagate_error(root);
+            }
+            for (size_t i = 0; i < vars.size(); i++) {
+                if (steps[i] != 0) scope.set(i, values[i]);
+            }
+            reclaim_loop_numbers(loop_serial); // 이전 반복의 값은 더 이상 묶여 있지 않음
+        }
+    }
+
+    // @param root: root node 포인터.
+    // @return 결과 해시 값 또는 node 포인터. 오류가 발생하면 EVAL_ERROR.
+    int eval(const int root) {
+        if (root == 0) {
+            return 0;
+        }
+
+        if (root < 0) { // symbol
+            if (hash_table.is_number(root)) { // symbol is a number
+                return root;
+            } else if (hash_table.get_pointer(root) == 0 &&
+                       (hash_table.get_value(root) == "#t" || hash_table.get_value(root) == "#f")) { // boolean
+                return root;
+            } else if (hash_table.get_pointer(root) == 0 && !library_index.empty()) { // require한 library의 정의
+                return load_library_value(root);
+            } else { // symbol is not a number
+                return hash_table.get_pointer(root);
+            }
+        }
+
+        if (node_array.is_object(root)) { // 문자열 literal, port 등
+            return root;
+        }
+
+        if (--steps_left < 0) {
+            return raise_error(root, Interpreter::LimitExceeded("evaluation step", eval_limits.max_steps));
+        }
+
+        if (get_lchild(root) > 0) {
+            // ((lambda (x) ...) arg ...)
+            const int func_ptr = eval(get_lchild(root));
+            if (func_ptr == EVAL_ERROR) return propagate_error(root);
+            return call_procedure(root, 0, func_ptr);
+        }
+
+        std::string token_index = hash_table.get_value(get_lchild(root));
+
+        if (token_index == "+" || token_index == "-" || token_index == "*" || token_index == "/" || token_index == "%") {
+            double result = 0.0;
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            const int arg1 = eval(get_lchild(argument));
+            if (arg1 == EVAL_ERROR) return propagate_error(root);
+            const int arg2 = eval(get_lchild(get_rchild(argument)));
+            if (arg2 == EVAL_ERROR) return propagate_error(root);
+            if (check_number_operand(arg1) == EVAL_ERROR || check_number_operand(arg2) == EVAL_ERROR) {
+                return propagate_error(root);
+            }
+
+            switch (token_index[0]) {
+            case '+':
+                result = to_number(arg1) + to_number(arg2);
+                break;
+
+            case '-':
+                result = to_number(arg1) - to_number(arg2);
+                break;
+            
+            case '*':
+                result = to_number(arg1) * to_number(arg2);
+                break;
+            
+            case '/':
+                result = to_number(arg1) / to_number(arg2);
+                break;
+            }
+
+            return make_number(result);
+
+        } else if (token_index == "=") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            const int arg1 = eval(get_lchild(argument));
+            if (arg1 == EVAL_ERROR) return propagate_error(root);
+            const int arg2 = eval(get_lchild(get_rchild(argument)));
+            if (arg2 == EVAL_ERROR) return propagate_error(root);
+
+            if (check_number_operand(arg1) == EVAL_ERROR || check_number_operand(arg2) == EVAL_ERROR) {
+                return propagate_error(root);
+            }
+
+            if (arg1 == arg2) {
+                return hash_table.get_hash_value("#t");
+            } else {
+                return hash_table.get_hash_value("#f");
+            }
+        
+        } else if (token_index == "eq?") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            int arg1 = get_lchild(argument);
+            if (arg1 < 0) {
+                if (hash_table.get_pointer(arg1) != 0) {
+                    arg1 = hash_table.get_pointer(arg1);
+                }
+            }
+
+            int arg2 = get_lchild(get_rchild(argument));
+            if (arg2 < 0) {
+                if (hash_table.get_pointer(arg2) != 0) {
+                    arg2 = hash_table.get_pointer(arg2);
+                }
+            }
+
+            if (arg1 == arg2) {
+                return hash_table.get_hash_value("#t");
+            } else {
+                return hash_table.get_hash_value("#f");
+            }
+
+        } else if (token_index == "equal?") {
+            const int argument = get_rchild(root);
+            
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            int arg1 = get_lchild(argument);
+            if (arg1 < 0) {
+                if (hash_table.get_pointer(arg1) != 0) {
+                    arg1 = hash_table.get_pointer(arg1);
+                }
+            }
+
+            int arg2 = get_lchild(get_rchild(argument));
+            if (arg2 < 0) {
+                if (hash_table.get_pointer(arg2) != 0) {
+                    arg2 = hash_table.get_pointer(arg2);
+                }
+            }
+
+            if (is_equal_structure(arg1, arg2)) {
+                return hash_table.get_hash_value("#t");
+            } else {
+                return hash_table.get_hash_value("#f");
+            }
+
+        } else if (token_index == "number?") {
+            const int argument = get_rchild(root);
+            
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            if (arg < 0 && hash_table.is_number(arg)) {
+                return hash_table.get_hash_value("#t");
+            } else {
+                return hash_table.get_hash_value("#f");
+            }
+            
+        } else if (token_index == "symbol?") {
+            const int argument = get_rchild(root);
+            
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = get_lchild(argument);
+            if (arg < 0 && hash_table.get_pointer(arg) != 0) {
+                return hash_table.get_hash_value("#t");
+            }
+            if (arg > 0) {
+                const int value = eval(arg);
+                if (value == EVAL_ERROR) return propagate_error(root);
+                if (value != 0) {
+                    return hash_table.get_hash_value("#t");
+                }
+            }
+
+            return hash_table.get_hash_value("#f");
+
+        } else if (token_index == "null?") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            if (arg == 0) {
+                return hash_table.get_hash_value("#t");
+            } else {
+                return hash_table.get_hash_value("#f");
+            }
+
+        } else if (token_index == "cons") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            int temp_ptr = alloc_cons(root);
+            const int head = eval(get_lchild(argument));
+            if (head == EVAL_ERROR) return propagate_error(root);
+            const int tail = eval(get_lchild(get_rchild(argument)));
+            if (tail == EVAL_ERROR) return propagate_error(root);
+
+            node_array.set_head(temp_ptr, head);
+            node_array.set_tail(temp_ptr, tail);
+            return temp_ptr;
+
+        } else if (token_index == "cond") {
+            const int true_hash = hash_table.get_hash_value("#t");
+            const int false_hash = hash_table.get_hash_value("#f");
+            int temp_root = root;
+            while (get_rchild(get_rchild(temp_root)) != 0) {
+                temp_root = get_rchild(temp_root);
+
+                const int test = eval(get_lchild(get_lchild(temp_root)));
+                if (test == EVAL_ERROR) return propagate_error(root);
+                if (test != true_hash && test != false_hash) {
+                    return raise_error(root, Interpreter::WrongTypeError("a boolean", get_output_string(test)));
+                }
+
+                if (test == true_hash) {
+                    const int result = eval(get_lchild(get_rchild(get_lchild(temp_root))));
+                    if (result == EVAL_ERROR) return propagate_error(root);
+                    return result;
+                }
+            }
+
+            // 마지막 절은 반드시 else
+            const int else_keyword = get_lchild(get_lchild(get_rchild(temp_root)));
+            if (else_keyword >= 0 || hash_table.get_value(else_keyword) != "else") {
+                return raise_error(root, Interpreter::MissingElseClause());
+            }
+
+            const int result = eval(get_lchild(get_rchild(get_lchild(get_rchild(temp_root)))));
+            if (result == EVAL_ERROR) return propagate_error(root);
+            return result;
+
+        } else if (token_index == "car") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            return get_lchild(arg);
+
+        } else if (token_index == "cdr") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            return get_rchild(arg);
+
+        } else if (token_index == "define") {
+            // 재정의된 함수의 변환 결과 무효화
+            compiled_lambdas.erase(get_lchild(get_rchild(root)));
+            jit_lambdas.erase(get_lchild(get_rchild(root)));
+
+            if (is_lambda(get_lchild(get_rchild(get_rchild(root))))) {
+                // function define
+                hash_table.set_pointer(get_lchild(get_rchild(root)), promote(get_lchild(get_rchild(get_rchild(root)))));
+            } else {
+                // value define
+                if (get_lchild(get_rchild(get_rchild(root))) < 0) {
+                    // symbol define
+                    hash_table.set_pointer(get_lchild(get_rchild(root)), get_lchild(get_rchild(get_rchild(root))));
+                } else {
+                    // 'eval(list) -> symbol' define
+                    const int value = eval(get_lchild(get_rchild(get_rchild(root))));
+                    if (value == EVAL_ERROR) return propagate_error(root);
+                    hash_table.set_pointer(get_lchild(get_rchild(root)), promote(value));
+                }
+                
+            }
+
+            return root;
+
+        } else if (token_index == "quote") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 1개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            return promote(get_lchild(argument));
+
+        } else if (token_index == "<" || token_index == ">") {
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 2개가 아닐 경우 오류 출력
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            const int arg1 = eval(get_lchild(argument));
+            if (arg1 == EVAL_ERROR) return propagate_error(root);
+            if (check_number_operand(arg1) == EVAL_ERROR) return propagate_error(root);
+
+            const int arg2 = eval(get_lchild(get_rchild(argument)));
+            if (arg2 == EVAL_ERROR) return propagate_error(root);
+            if (check_number_operand(arg2) == EVAL_ERROR) return propagate_error(root);
+
+            bool is_true = false;
+
+            switch (token_index[0]) {
+                case '<':
+                    is_true = (to_number(arg1) < to_number(arg2));
+                    break;
+                case '>':
+                    is_true = (to_number(arg1) > to_number(arg2));
+            }
+
+            return is_true ? hash_table.get_hash_value("#t") : hash_table.get_hash_value("#f");
+            
+        } else if (token_index == "print" || token_index == "display") {
+            // 출력
+            const int argument = get_rchild(root);
+
+            // 인자 개수가 1개가 아닐 경우 오류 출력 (display는 port를 받을 수 있음)
+            const int params = count_params(root);
+            if (params != 1 && (params != 2 || token_index != "display")) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            if (params == 2) {
+                // (display obj port): 문자열은 따옴표 없이 port에 출력
+                OutputPort* port = eval_output_port(root, get_rchild(argument));
+                if (port == nullptr) return EVAL_ERROR;
+
+                std::string output = "";
+                get_output(arg, true, output, true);
+                port->write(output.erase(output.find_last_not_of(' ') + 1));
+                return 0;
+            }
+            return arg;
+
+        } else if (token_index == "write") {
+            // (write obj), (write obj port)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 1 && params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(argument));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            OutputPort* port = eval_output_port(root, get_rchild(argument));
+            if (port == nullptr) return EVAL_ERROR;
+
+            port->write(get_output_string(arg));
+            return 0;
+
+        } else if (token_index == "require") {
+            // (require "lib"): lib (또는 lib.scm)의 define은 처음 쓰일 때 읽고, 나머지 최상위 식은 바로 계산
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            std::string path = "";
+            if (!eval_string(root, get_lchild(get_rchild(root)), path)) return EVAL_ERROR;
+            if (require_library(root, path) == EVAL_ERROR) return EVAL_ERROR;
+
+            return hash_table.get_hash_value("#t");
+
+        } else if (token_index == HashTable::symbol_name("dump-trace")) {
+            // (dump-trace): --trace로 지정한 file에 지금까지의 trace를 씀
+            const int params = count_params(root);
+            if (params != 0) {
+                return raise_error(root, Interpreter::InconsistentArguments(0, params));
+            }
+
+            return hash_table.get_hash_value(dump_trace() ? "#t" : "#f");
+
+        } else if (token_index == HashTable::symbol_name("heap-snapshot")) {
+            // (heap-snapshot "file"): 살아 있는 cell과 root의 참조 graph를 JSON으로 씀 (tools/heap_report.cpp로 분석)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            std::string path = "";
+            if (!eval_string(root, get_lchild(get_rchild(root)), path)) return EVAL_ERROR;
+
+            return hash_table.get_hash_value(dump_heap_snapshot(path) ? "#t" : "#f");
+
+        } else if (token_index == "newline") {
+            // (newline), (newline port)
+            const int params = count_params(root);
+            if (params > 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(0, params));
+            }
+
+            OutputPort* port = eval_output_port(root, get_rchild(root));
+            if (port == nullptr) return EVAL_ERROR;
+
+            port->write("\n");
+            return 0;
+
+        } else if (token_index == HashTable::symbol_name("open-input-file") ||
+                   token_index == HashTable::symbol_name("open-output-file")) {
+            // (open-input-file "path"), (open-output-file "path")
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            std::string path = "";
+            if (!eval_string(root, get_lchild(get_rchild(root)), path)) return EVAL_ERROR;
+
+            HeapObject* port = nullptr;
+            if (token_index == HashTable::symbol_name("open-input-file")) {
+                port = InputPort::open(path);
+            } else {
+                port = OutputPort::open(path);
+            }
+            if (port == nullptr) {
+                return raise_error(root, Interpreter::FileError(path));
+            }
+
+            return make_object(port);
+
+        } else if (token_index == "close-port" || token_index == HashTable::symbol_name("close-input-port") ||
+                   token_index == HashTable::symbol_name("close-output-port")) {
+            // (close-port port): 출력 port는 남은 내용을 쓰고 닫음
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int value = eval(get_lchild(get_rchild(root)));
+            if (value == EVAL_ERROR) return propagate_error(root);
+
+            HeapObject* object = get_object(value);
+            if (dynamic_cast<InputPort*>(object) != nullptr) {
+                dynamic_cast<InputPort*>(object)->close();
+            } else if (dynamic_cast<OutputPort*>(object) != nullptr) {
+                dynamic_cast<OutputPort*>(object)->close();
+            } else {
+                return raise_error(root, Interpreter::WrongTypeError("a port", get_output_string(value)));
+            }
+
+            return 0;
+
+        } else if (token_index == "read-line" || token_index == "read-char" || token_index == "peek-char" ||
+                   token_index == "read") {
+            // (read-line port), (read-char port), (peek-char port), (read port)
+            // 문자는 한 글자 문자열, file의 끝은 #<eof>
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            InputPort* port = eval_port<InputPort>(root, get_lchild(get_rchild(root)), "an open input port");
+            if (port == nullptr) return EVAL_ERROR;
+
+            if (token_index == "read-line") {
+                std::string line = "";
+                if (!port->read_line(line)) {
+                    return eof_object();
+                }
+                return make_object(new StringObject(line));
+            } else if (token_index == "read") {
+                std::string text = "";
+                if (!port->read_datum(text)) {
+                    return eof_object();
+                }
+                return parse_datum(text);
+            }
+
+            const int c = (token_index == "read-char") ? port->read_char() : port->peek_char();
+            if (c == EOF) {
+                return eof_object();
+            }
+            return make_object(new StringObject(std::string(1, static_cast<char>(c))));
+
+        } else if (token_index == HashTable::symbol_name("eof-object?")) {
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(get_rchild(root)));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            return (arg == eof_object()) ? hash_table.get_hash_value("#t") : hash_table.get_hash_value("#f");
+
+        } else if (token_index == HashTable::symbol_name("with-output-to-file")) {
+            // (with-output-to-file "path" thunk): thunk를 계산하는 동안 write, newline 등의 출력을 file로 보냄
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            std::string path = "";
+            if (!eval_string(root, get_lchild(argument), path)) return EVAL_ERROR;
+            const int thunk = eval(get_lchild(get_rchild(argument)));
+            if (thunk == EVAL_ERROR) return propagate_error(root);
+
+            std::unique_ptr<OutputPort> port(OutputPort::open(path));
+            if (!port) {
+                return raise_error(root, Interpreter::FileError(path));
+            }
+
+            OutputPort* orig_port = current_output_port;
+            current_output_port = port.get();
+
+            int result = 0;
+            try {
+                result = apply_procedure(root, thunk, EvalFuncStack());
+            } catch (...) {
+                current_output_port = orig_port;
+                throw;
+            }
+            current_output_port = orig_port;
+
+            return result;
+
+        } else if (token_index == "delay") {
+            // (delay expr): expr은 force할 때 계산
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            return make_promise(get_lchild(get_rchild(root)));
+
+        } else if (token_index == HashTable::symbol_name("make-promise")) {
+            // (make-promise value): 이미 계산된 promise (promise는 그대로)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(get_rchild(root)));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            if (dynamic_cast<Promise*>(get_object(arg)) != nullptr) {
+                return arg;
+            }
+
+            return make_object(Promise::make_forced(arg));
+
+        } else if (token_index == "force") {
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(get_rchild(root)));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            return force_promise(root, arg);
+
+        } else if (token_index == "promise?") {
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(get_rchild(root)));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+
+            return (dynamic_cast<Promise*>(get_object(arg)) != nullptr) ? hash_table.get_hash_value("#t") : hash_table.get_hash_value("#f");
+
+        } else if (token_index == HashTable::symbol_name("cons-stream")) {
+            // (cons-stream head tail) => (cons head (delay tail))
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            const int head = eval(get_lchild(argument));
+            if (head == EVAL_ERROR) return propagate_error(root);
+            const int tail = make_promise(get_lchild(get_rchild(argument)));
+
+            const int temp_ptr = node_array_alloc();
+            node_array.set_head(temp_ptr, head);
+            node_array.set_tail(temp_ptr, tail);
+            return temp_ptr;
+
+        } else if (token_index == "stream-car" || token_index == "stream-cdr") {
+            // stream-cdr은 tail의 promise를 force
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            const int arg = eval(get_lchild(get_rchild(root)));
+            if (arg == EVAL_ERROR) return propagate_error(root);
+            if (arg <= 0 || node_array.is_object(arg)) {
+                return raise_error(root, Interpreter::WrongTypeError("a stream", get_output_string(arg)));
+            }
+
+            if (token_index == "stream-car") {
+                return get_lchild(arg);
+            }
+            return force_promise(root, get_rchild(arg));
+
+        } else if (token_index == "lambda") {
+            // lambda는 자기 자신으로 계산
+            return promote(root);
+
+        } else if (token_index == "begin") {
+            int result = 0;
+            for (int argument = get_rchild(root); argument != 0; argument = get_rchild(argument)) {
+                result = eval(get_lchild(argument));
+                if (result == EVAL_ERROR) return propagate_error(root);
+            }
+
+            return result;
+
+        } else if (token_index == "let" || token_index == "let*") {
+            return eval_let(root, token_index == "let*");
+
+        } else if (token_index == "do") {
+            return eval_do(root);
+
+        } else if (token_index == HashTable::symbol_name("define-record-type")) {
+            return define_record_type(root);
+
+        } else if (token_index == HashTable::symbol_name("define-syntax")) {
+            // 정의는 read 단계에서 macro 전개기가 처리
+            if (!macro_expander.is_macro(get_lchild(get_rchild(root)))) {
+                return raise_error(root, Interpreter::BadSyntax(token_index));
+            }
+
+            return root;
+
+        } else if (token_index == HashTable::symbol_name("make-hash-table")) {
+            // (make-hash-table), (make-hash-table eq?), (make-hash-table equal?)
+            const int params = count_params(root);
+            if (params > 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            NativeHashTable::KeyEquality key_equality = NativeHashTable::KeyEquality::EQUAL;
+            if (params == 1) {
+                int equality = get_lchild(get_rchild(root));
+                if (equality > 0) { // 'eq?
+                    equality = eval(equality);
+                    if (equality == EVAL_ERROR) return propagate_error(root);
+                }
+
+                if (equality < 0 && hash_table.get_value(equality) == "eq?") {
+                    key_equality = NativeHashTable::KeyEquality::EQ;
+                } else if (equality >= 0 || hash_table.get_value(equality) != "equal?") {
+                    return raise_error(root, Interpreter::WrongTypeError("eq? or equal?", get_output_string(equality)));
+                }
+            }
+
+            return make_object(new NativeHashTable(
+                key_equality,
+                [this](const int key) { return hash_structure(key); },
+                [this](const int key1, const int key2) { return is_equal_structure(key1, key2); }));
+
+        } else if (token_index == "hash-ref") {
+            // (hash-ref table key), (hash-ref table key default)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2 && params != 3) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            NativeHashTable* table = eval_hash_table(root, get_lchild(argument));
+            if (table == nullptr) return EVAL_ERROR;
+            const int key = eval(get_lchild(get_rchild(argument)));
+            if (key == EVAL_ERROR) return propagate_error(root);
+
+            int value = 0;
+            if (table->get(key, value)) {
+                return value;
+            }
+
+            if (params == 2) {
+                return raise_error(root, Interpreter::MissingKey(get_output_string(key)));
+            }
+
+            value = eval(get_lchild(get_rchild(get_rchild(argument))));
+            if (value == EVAL_ERROR) return propagate_error(root);
+            return value;
+
+        } else if (token_index == "hash-set!") {
+            // (hash-set! table key value)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 3) {
+                return raise_error(root, Interpreter::InconsistentArguments(3, params));
+            }
+
+            NativeHashTable* table = eval_hash_table(root, get_lchild(argument));
+            if (table == nullptr) return EVAL_ERROR;
+            const int key = eval(get_lchild(get_rchild(argument)));
+            if (key == EVAL_ERROR) return propagate_error(root);
+            const int value = eval(get_lchild(get_rchild(get_rchild(argument))));
+            if (value == EVAL_ERROR) return propagate_error(root);
+
+            table->set(key, value);
+            return value;
+
+        } else if (token_index == HashTable::symbol_name("hash-remove!")) {
+            // (hash-remove! table key)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            NativeHashTable* table = eval_hash_table(root, get_lchild(argument));
+            if (table == nullptr) return EVAL_ERROR;
+            const int key = eval(get_lchild(get_rchild(argument)));
+            if (key == EVAL_ERROR) return propagate_error(root);
+
+            return table->remove(key) ? hash_table.get_hash_value("#t") : hash_table.get_hash_value("#f");
+
+        } else if (token_index == "hash-count") {
+            // (hash-count table)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+
+            NativeHashTable* table = eval_hash_table(root, get_lchild(get_rchild(root)));
+            if (table == nullptr) return EVAL_ERROR;
+
+            return make_number(static_cast<double>(table->size()));
+
+        } else if (token_index == HashTable::symbol_name("hash-update!")) {
+            // (hash-update! table key procedure), (hash-update! table key procedure default)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 3 && params != 4) {
+                return raise_error(root, Interpreter::InconsistentArguments(3, params));
+            }
+
+            NativeHashTable* table = eval_hash_table(root, get_lchild(argument));
+            if (table == nullptr) return EVAL_ERROR;
+            const int key = eval(get_lchild(get_rchild(argument)));
+            if (key == EVAL_ERROR) return propagate_error(root);
+            const int procedure = eval(get_lchild(get_rchild(get_rchild(argument))));
+            if (procedure == EVAL_ERROR) return propagate_error(root);
+
+            int value = 0;
+            if (!table->get(key, value)) {
+                if (params == 3) {
+                    return raise_error(root, Interpreter::MissingKey(get_output_string(key)));
+                }
+
+                value = eval(get_lchild(get_rchild(get_rchild(get_rchild(argument)))));
+                if (value == EVAL_ERROR) return propagate_error(root);
+            }
+
+            EvalFuncStack arg_values;
+            arg_values.push(0, value);
+            const int result = apply_procedure(root, procedure, arg_values);
+            if (result == EVAL_ERROR) return EVAL_ERROR;
+
+            table->set(key, result);
+            return result;
+
+        } else if (token_index == HashTable::symbol_name("hash-for-each")) {
+            // (hash-for-each table procedure): procedure를 (key value)로 호출
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
             }
 
-            if (root < 0) { // symbol
-                if (is_number(hash_table.get_value(root))) { // symbol is a number
-                    return root;
-                } else { // symbol is not a number
-                    return hash_table.get_pointer(root);
-                }
+            NativeHashTable* table = eval_hash_table(root, get_lchild(argument));
+            if (table == nullptr) return EVAL_ERROR;
+            const int procedure = eval(get_lchild(get_rchild(argument)));
+            if (procedure == EVAL_ERROR) return propagate_error(root);
+
+            // procedure가 table에서 지운 항목도 순회하는 동안 보존되도록 (key, value)를 이어서 복사
+            std::vector<int> entries;
+            const ValueScope entry_scope(current_generator, entries);
+            for (const std::pair<int, int>& entry : table->entries()) {
+                entries.push_back(entry.first);
+                entries.push_back(entry.second);
+            }
+            for (size_t i = 0; i < entries.size(); i += 2) {
+                EvalFuncStack arg_values;
+                arg_values.push(0, entries[i]);
+                arg_values.push(0, entries[i + 1]);
+                if (apply_procedure(root, procedure, arg_values) == EVAL_ERROR) return EVAL_ERROR;
             }
 
-            std::string token_index = hash_table.get_value(get_lchild(root));
+            return 0;
 
-            if (token_index == "+" || token_index == "-" || token_index == "*" || token_index == "/" || token_index == "%") {
-                double result = 0.0;
-                const int argument = get_rchild(root);
+        } else if (token_index == "hash->list") {
+            // (hash->list table) => ((key value) ...)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
-                }
+            NativeHashTable* table = eval_hash_table(root, get_lchild(get_rchild(root)));
+            if (table == nullptr) return EVAL_ERROR;
 
-                switch (token_index[0]) {
-                case '+':
-                    result = get_val(hash_table.get_value(eval(get_lchild(argument)))) +
-                            get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument)))));
-                    break;
+            int list_ptr = 0;
+            for (const std::pair<int, int>& entry : table->entries()) {
+                const int value_ptr = node_array_alloc();
+                node_array.set_head(value_ptr, entry.second);
+                node_array.set_tail(value_ptr, 0);
 
-                case '-':
-                    result = get_val(hash_table.get_value(eval(get_lchild(argument)))) -
-                            get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument)))));
-                    break;
-                
-                case '*':
-                    result = get_val(hash_table.get_value(eval(get_lchild(argument)))) *
-                            get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument)))));
-                    break;
-                
-                case '/':
-                    result = get_val(hash_table.get_value(eval(get_lchild(argument)))) /
-                            get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument)))));
-                    break;
-                }
+                const int key_ptr = node_array_alloc();
+                node_array.set_head(key_ptr, entry.first);
+                node_array.set_tail(key_ptr, value_ptr);
 
-                std::string result_str = std::to_string(result);
+                const int temp_ptr = node_array_alloc();
+                node_array.set_head(temp_ptr, key_ptr);
+                node_array.set_tail(temp_ptr, list_ptr);
+                list_ptr = temp_ptr;
+            }
 
-                // 부동소수점 오차 제거
-                return hash_table.get_hash_value(trunc_decimal(result_str));
+            return list_ptr;
 
-            } else if (token_index == "=") {
-                const int argument = get_rchild(root);
+        } else if (token_index == "length") {
+            // (length list)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
-                }
+            std::vector<int> values;
+            if (!eval_list_elements(root, get_lchild(get_rchild(root)), values)) return EVAL_ERROR;
 
-                const int arg1 = eval(get_lchild(argument));
-                const int arg2 = eval(get_lchild(get_rchild(argument)));
+            return make_number(static_cast<double>(values.size()));
 
-                // symbol이 아닐 때
-                if (arg1 >= 0) {
-                    std::string operand = "";
-                    get_output(arg1, true, operand);
-                    operand = operand.substr(0, operand.length() - 1);
-                    throw Interpreter::NotNumberError(operand);
-                }
-                if (arg2 >= 0) {
-                    std::string operand = "";
-                    get_output(arg2, true, operand);
-                    operand = operand.substr(0, operand.length() - 1);
-                    throw Interpreter::NotNumberError(operand);
-                }
-                // symbol이지만 number가 아닐 때
-                if (!is_number(hash_table.get_value(arg1))) {
-                    throw Interpreter::NotNumberError(hash_table.get_value(arg1));
-                }
-                if (!is_number(hash_table.get_value(arg2))) {
-                    throw Interpreter::NotNumberError(hash_table.get_value(arg2));
-                }
+        } else if (token_index == "list-ref") {
+            // (list-ref list k)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
 
-                if (arg1 == arg2) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
-                }
-            
-            } else if (token_index == "eq?") {
-                const int argument = get_rchild(root);
+            std::vector<int> values;
+            const ValueScope value_scope(current_generator, values);
+            if (!eval_list_elements(root, get_lchild(argument), values)) return EVAL_ERROR;
+            const int index = eval(get_lchild(get_rchild(argument)));
+            if (index == EVAL_ERROR) return propagate_error(root);
+            if (check_number_operand(index) == EVAL_ERROR) return propagate_error(root);
 
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
-                }
+            const double position = to_number(index);
+            if (position < 0 || position >= values.size() || position != std::floor(position)) {
+                return raise_error(root, Interpreter::IndexOutOfRange(hash_table.get_value(index), values.size()));
+            }
 
-                int arg1 = get_lchild(argument);
-                if (arg1 < 0) {
-                    if (hash_table.get_pointer(arg1) != 0) {
-                        arg1 = hash_table.get_pointer(arg1);
-                    }
-                }
+            return values[static_cast<size_t>(position)];
 
-                int arg2 = get_lchild(get_rchild(argument));
-                if (arg2 < 0) {
-                    if (hash_table.get_pointer(arg2) != 0) {
-                        arg2 = hash_table.get_pointer(arg2);
-                    }
-                }
+        } else if (token_index == "append") {
+            // (append list ...): 마지막 list는 복사하지 않고 공유
+            std::vector<int> lists;
+            const ValueScope value_scope(current_generator, lists);
+            for (int argument = get_rchild(root); argument != 0; argument = get_rchild(argument)) {
+                const int list = eval(get_lchild(argument));
+                if (list == EVAL_ERROR) return propagate_error(root);
+                lists.push_back(list);
+            }
+            if (lists.empty()) {
+                return 0;
+            }
 
-                if (arg1 == arg2) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
-                }
+            std::vector<int> values;
+            for (size_t i = 0; i + 1 < lists.size(); i++) {
+                if (!list_elements(root, lists[i], values)) return EVAL_ERROR;
+            }
 
-            } else if (token_index == "equal?") {
-                const int argument = get_rchild(root);
-                
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
-                }
+            return make_list_from(values, lists.back());
 
-                int arg1 = get_lchild(argument);
-                if (arg1 < 0) {
-                    if (hash_table.get_pointer(arg1) != 0) {
-                        arg1 = hash_table.get_pointer(arg1);
-                    }
-                }
+        } else if (token_index == "reverse") {
+            // (reverse list)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-                int arg2 = get_lchild(get_rchild(argument));
-                if (arg2 < 0) {
-                    if (hash_table.get_pointer(arg2) != 0) {
-                        arg2 = hash_table.get_pointer(arg2);
-                    }
-                }
+            std::vector<int> values;
+            if (!eval_list_elements(root, get_lchild(get_rchild(root)), values)) return EVAL_ERROR;
 
-                if (is_equal_structure(arg1, arg2)) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
-                }
+            return make_list_from(std::vector<int>(values.rbegin(), values.rend()));
 
-            } else if (token_index == "number?") {
-                const int argument = get_rchild(root);
-                
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+        } else if (token_index == "map") {
+            // (map procedure list ...): 가장 짧은 list의 길이만큼 호출
+            const int params = count_params(root);
+            if (params < 2 || params > EvalFuncStack::MAX_PARAMS + 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
 
-                if (is_number(hash_table.get_value(eval(get_lchild(argument))))) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
-                }
-                
-            } else if (token_index == "symbol?") {
-                const int argument = get_rchild(root);
-                
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+            int builtin = 0;
+            const int procedure = eval_procedure(get_lchild(get_rchild(root)), builtin);
+            if (procedure == EVAL_ERROR) return propagate_error(root);
+
+            // list마다 원소를 elements에 이어 붙이고 시작 위치를 기록
+            std::vector<int> elements;
+            std::vector<size_t> starts;
+            const ValueScope value_scope(current_generator, elements);
+            size_t length = SIZE_MAX;
+            for (int argument = get_rchild(get_rchild(root)); argument != 0; argument = get_rchild(argument)) {
+                starts.push_back(elements.size());
+                if (!eval_list_elements(root, get_lchild(argument), elements)) return EVAL_ERROR;
+                if (elements.size() - starts.back() < length) length = elements.size() - starts.back();
+            }
 
-                if ((get_lchild(get_rchild(root)) < 0 && hash_table.get_pointer(get_lchild(get_rchild(root))) != 0) ||
-                    (get_lchild(get_rchild(root)) > 0 && eval(get_lchild(get_rchild(root))) != 0)) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
+            std::vector<int> results;
+            const ValueScope result_scope(current_generator, results);
+            results.reserve(length);
+            for (size_t i = 0; i < length; i++) {
+                EvalFuncStack arg_values;
+                for (const size_t start : starts) {
+                    arg_values.push(0, elements[start + i]);
                 }
 
-            } else if (token_index == "null?") {
-                const int argument = get_rchild(root);
+                const int result = apply_callback(root, builtin, procedure, arg_values);
+                if (result == EVAL_ERROR) return EVAL_ERROR;
+                results.push_back(result);
+            }
 
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+            return make_list_from(results);
 
-                if (argument == 0 || eval(get_lchild(argument)) == 0) {
-                    return hash_table.get_hash_value("#t");
-                } else {
-                    return hash_table.get_hash_value("#f");
+        } else if (token_index == "filter") {
+            // (filter predicate list): #f가 아닌 결과를 낸 원소만 남김
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            int builtin = 0;
+            const int predicate = eval_procedure(get_lchild(argument), builtin);
+            if (predicate == EVAL_ERROR) return propagate_error(root);
+            std::vector<int> values;
+            const ValueScope value_scope(current_generator, values);
+            if (!eval_list_elements(root, get_lchild(get_rchild(argument)), values)) return EVAL_ERROR;
+
+            const int false_hash = hash_table.get_hash_value("#f");
+            std::vector<int> results;
+            const ValueScope result_scope(current_generator, results);
+            for (const int value : values) {
+                EvalFuncStack arg_values;
+                arg_values.push(0, value);
+
+                const int keep = apply_callback(root, builtin, predicate, arg_values);
+                if (keep == EVAL_ERROR) return EVAL_ERROR;
+                if (keep != false_hash) {
+                    results.push_back(value);
                 }
+            }
+
+            return make_list_from(results);
+
+        } else if (token_index == "fold" || token_index == "fold-left" || token_index == "fold-right") {
+            // (fold kons knil list): (kons x acc), 앞에서부터
+            // (fold-left f init list): (f acc x), 앞에서부터
+            // (fold-right f init list): (f x acc), 뒤에서부터
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 3) {
+                return raise_error(root, Interpreter::InconsistentArguments(3, params));
+            }
+
+            int builtin = 0;
+            const int procedure = eval_procedure(get_lchild(argument), builtin);
+            if (procedure == EVAL_ERROR) return propagate_error(root);
+            int accumulator = eval(get_lchild(get_rchild(argument)));
+            if (accumulator == EVAL_ERROR) return propagate_error(root);
+            std::vector<int> values;
+            const ValueScope value_scope(current_generator, values);
+            if (!eval_list_elements(root, get_lchild(get_rchild(get_rchild(argument))), values)) return EVAL_ERROR;
+
+            if (token_index == "fold-right") {
+                std::reverse(values.begin(), values.end());
+            }
+            const bool accumulator_first = (token_index == "fold-left");
+            for (const int value : values) {
+                EvalFuncStack arg_values;
+                arg_values.push(0, accumulator_first ? accumulator : value);
+                arg_values.push(0, accumulator_first ? value : accumulator);
+
+                accumulator = apply_callback(root, builtin, procedure, arg_values);
+                if (accumulator == EVAL_ERROR) return EVAL_ERROR;
+            }
 
-            } else if (token_index == "cons") {
-                const int argument = get_rchild(root);
+            return accumulator;
 
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
+        } else if (token_index == "assoc") {
+            // (assoc key alist): car가 key와 equal?인 첫 원소. (없으면 #f)
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
+
+            const int key = eval(get_lchild(argument));
+            if (key == EVAL_ERROR) return propagate_error(root);
+            std::vector<int> entries;
+            if (!eval_list_elements(root, get_lchild(get_rchild(argument)), entries)) return EVAL_ERROR;
+
+            for (const int entry : entries) {
+                if (entry <= 0 || node_array.is_object(entry)) {
+                    return raise_error(root, Interpreter::WrongTypeError("a pair", get_output_string(entry)));
+                }
+                if (is_equal_structure(key, get_lchild(entry))) {
+                    return entry;
                 }
+            }
 
-                int temp_ptr = node_array_alloc();
-                node_array.set_head(temp_ptr, eval(get_lchild(argument)));
-                node_array.set_tail(temp_ptr, eval(get_lchild(get_rchild(argument))));
-                return temp_ptr;
+            return hash_table.get_hash_value("#f");
 
-            } else if (token_index == "cond") {
-                int temp_root = root;
-                while (get_rchild(get_rchild(temp_root)) != 0) {
-                    temp_root = get_rchild(temp_root);
+        } else if (token_index == "sort" || token_index == "sort!") {
+            // (sort list less?): 안정 정렬한 새 list
+            // (sort! list less?): 정렬한 원소를 list의 cell에 다시 씀
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
 
-                    if (hash_table.get_value(eval(get_lchild(get_lchild(temp_root)))) == "#t") {
-                        return eval(get_lchild(get_rchild(get_lchild(temp_root))));
+            const int list = eval(get_lchild(argument));
+            if (list == EVAL_ERROR) return propagate_error(root);
+            std::vector<int> values; // 비교 함수를 호출하는 동안에도 모든 원소가 남아 있음 (MergeSort::sort_values)
+            const ValueScope value_scope(current_generator, values);
+            if (!list_elements(root, list, values)) return EVAL_ERROR;
+
+            if (token_index == "sort!") {
+                // hash-consing된 cell은 다른 곳과 공유하므로 바꾸지 않음 (--hash-cons가 없을 때와 결과가 달라지지 않도록 오류)
+                for (int cell = list; cell != 0; cell = get_rchild(cell)) {
+                    if (is_hash_consed(cell)) {
+                        return raise_error(root, Interpreter::SharedConstant(get_output_string(list)));
                     }
                 }
+            }
 
-                if (hash_table.get_value(get_lchild(get_lchild(get_rchild(temp_root)))) != "else") {
-                    throw "error";
+            // 기본 비교 함수는 값이 아니므로 이름으로 확인: 숫자 key만 비교하므로 병렬로 정렬할 수 있음
+            const int less_expr = get_lchild(get_rchild(argument));
+            const std::string less_name = (less_expr < 0) ? hash_table.get_value(less_expr) : "";
+            if ((less_name == "<" || less_name == ">") && hash_table.get_pointer(less_expr) == 0) {
+                std::vector<MergeSort::key_struct> keys;
+                keys.reserve(values.size());
+                for (const int value : values) {
+                    if (check_number_operand(value) == EVAL_ERROR) return propagate_error(root);
+                    keys.push_back(std::make_pair(to_number(value), value));
                 }
 
-                return eval(get_lchild(get_rchild(get_lchild(get_rchild(temp_root)))));
-
-            } else if (token_index == "car") {
-                const int argument = get_rchild(root);
+                MergeSort::sort_keys(keys, less_name == ">");
+                for (size_t i = 0; i < keys.size(); i++) {
+                    values[i] = keys[i].second;
+                }
+            } else {
+                const int less = eval(less_expr);
+                if (less == EVAL_ERROR) return propagate_error(root);
+
+                const int false_hash = hash_table.get_hash_value("#f");
+                const bool ok = MergeSort::sort_values(values, [this, root, less, false_hash](const int lhs, const int rhs, bool& result) {
+                    EvalFuncStack arg_values;
+                    arg_values.push(0, lhs);
+                    arg_values.push(0, rhs);
+
+                    const int is_less = apply_procedure(root, less, arg_values);
+                    if (is_less == EVAL_ERROR) return false;
+                    result = (is_less != false_hash);
+                    return true;
+                });
+                if (!ok) return EVAL_ERROR;
+            }
 
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
+            if (token_index == "sort!") {
+                int cell = list;
+                for (const int value : values) {
+                    node_array.set_head(cell, value);
+                    cell = get_rchild(cell);
                 }
+                return list;
+            }
 
-                return get_lchild(eval(get_lchild(argument)));
+            return make_list_from(values);
 
-            } else if (token_index == "cdr") {
-                const int argument = get_rchild(root);
+        } else if (token_index == "call/1cc") {
+            // (call/1cc procedure): one-shot continuation k를 넘겨 호출. procedure가 끝나기 전에 (k value)를 호출하면 바로 value를 반환
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+            const int procedure = eval(get_lchild(get_rchild(root)));
+            if (procedure == EVAL_ERROR) return propagate_error(root);
 
-                return get_rchild(eval(get_lchild(argument)));
+            Continuation* continuation = new Continuation(current_generator == nullptr ? 0 : running_generators.back());
+            const int k = make_object(continuation);
+            active_continuations.push_back(k);
 
-            } else if (token_index == "define") {
-                if (get_lchild(get_rchild(get_rchild(root))) > 0 &&
-                    hash_table.get_value(get_lchild(get_lchild(get_rchild(get_rchild(root))))) == "lambda") {
-                    // function define
-                    hash_table.set_pointer(get_lchild(get_rchild(root)), get_lchild(get_rchild(get_rchild(root))));
-                } else {
-                    // value define
-                    if (get_lchild(get_rchild(get_rchild(root))) < 0) {
-                        // symbol define
-                        hash_table.set_pointer(get_lchild(get_rchild(root)), get_lchild(get_rchild(get_rchild(root))));
-                    } else {
-                        // 'eval(list) -> symbol' define
-                        hash_table.set_pointer(get_lchild(get_rchild(root)), eval(get_lchild(get_rchild(get_rchild(root)))));
-                    }
-                    
-                }
+            EvalFuncStack arg_values;
+            arg_values.push(0, k);
+            int result = 0;
+            try {
+                result = apply_procedure(root, procedure, arg_values);
+            } catch (const Interpreter::ContinuationInvoked& invoked) {
+                close_continuation(k, continuation);
+                if (invoked.continuation != continuation) throw; // 바깥쪽 call/1cc의 continuation
+                return invoked.value;
+            } catch (...) {
+                close_continuation(k, continuation);
+                throw;
+            }
+            close_continuation(k, continuation);
 
-                return root;
+            return result;
+
+        } else if (token_index == HashTable::symbol_name("make-generator")) {
+            // (make-generator thunk): 호출할 때마다 thunk를 다음 yield까지 계산하는 generator
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-            } else if (token_index == "quote") {
-                const int argument = get_rchild(root);
+            const int procedure = eval(get_lchild(get_rchild(root)));
+            if (procedure == EVAL_ERROR) return propagate_error(root);
 
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+            return make_generator(root, procedure, false);
 
-                return get_lchild(argument);
+        } else if (token_index == "spawn") {
+            // (spawn thunk): thunk를 task로 실행하도록 scheduler에 추가
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-            } else if (token_index == "<" || token_index == ">") {
-                const int argument = get_rchild(root);
+            const int procedure = eval(get_lchild(get_rchild(root)));
+            if (procedure == EVAL_ERROR) return propagate_error(root);
 
-                // 인자 개수가 2개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 2) {
-                    throw Interpreter::InconsistentArguments(2, params);
-                }
+            const int task = make_generator(root, procedure, true);
+            if (task == EVAL_ERROR) return EVAL_ERROR;
+            live_tasks.insert(task);
+            ready_tasks.push_back(task);
 
-                if (!is_number(hash_table.get_value(eval(get_lchild(argument))))) {
-                    throw Interpreter::NotNumberError(hash_table.get_value(eval(get_lchild(argument))));
+            return task;
+
+        } else if (token_index == "yield") {
+            // (yield value): generator를 중단하고 호출한 쪽에 value를 넘김. 다시 (g x)로 호출되면 x를 반환
+            // (yield): task는 다른 task에게 차례를 넘기고, task 밖에서는 준비된 task를 한 번씩 실행
+            const int params = count_params(root);
+            if (params == 0) {
+                if (current_generator == nullptr) {
+                    for (size_t count = ready_tasks.size(); count > 0; count--) {
+                        if (run_next_task(root) == EVAL_ERROR) return EVAL_ERROR;
+                    }
+                    return 0;
                 }
-                if (!is_number(hash_table.get_value(eval(get_lchild(get_rchild(argument)))))) {
-                    throw Interpreter::NotNumberError(hash_table.get_value(eval(get_lchild(get_rchild(argument)))));
+                if (!current_generator->is_task()) {
+                    return raise_error(root, Interpreter::ControlError("yield without a value inside a generator"));
                 }
 
-                bool is_true = false;
+                current_generator->coroutine.yield();
+                return 0;
+            }
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
+            if (current_generator == nullptr || current_generator->is_task()) {
+                return raise_error(root, Interpreter::ControlError("yield with a value outside of a generator"));
+            }
 
-                switch (token_index[0]) {
-                    case '<':
-                        is_true = (get_val(hash_table.get_value(eval(get_lchild(argument)))) <
-                                get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument))))));
-                        break;
-                    case '>':
-                        is_true = (get_val(hash_table.get_value(eval(get_lchild(argument)))) >
-                                get_val(hash_table.get_value(eval(get_lchild(get_rchild(argument))))));
-                }
+            const int value = eval(get_lchild(get_rchild(root)));
+            if (value == EVAL_ERROR) return propagate_error(root);
 
-                return is_true ? hash_table.get_hash_value("#t") : hash_table.get_hash_value("#f");
-                
-            } else if (token_index == "print" || token_index == "display") {
-                // 출력
-                const int argument = get_rchild(root);
+            Generator* generator = current_generator;
+            generator->set_transfer(value);
+            generator->coroutine.yield();
 
-                // 인자 개수가 1개가 아닐 경우 오류 출력
-                const int params = count_params(root);
-                if (params != 1) {
-                    throw Interpreter::InconsistentArguments(1, params);
-                }
+            const int sent = generator->get_transfer();
+            generator->set_transfer(0);
+            return sent;
 
-                return eval(get_lchild(argument));
+        } else if (token_index == HashTable::symbol_name("make-channel")) {
+            // (make-channel capacity)
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-            } else if (hash_table.get_pointer(hash_table.get_hash_value(token_index)) != 0) {
-                // 사용자 정의 function / value
-                EvalFuncStack eval_func_stack; // 함수 호출 전의 hash table 조각의 값을 저장
-                EvalFuncStack temp_arg_stack; // 인자(argument)로 넣을 값을 임시로 저장(모든 인자 계산이 끝나기 전까지 hash table을 건드리면 안 됨)
+            const int capacity = eval(get_lchild(get_rchild(root)));
+            if (capacity == EVAL_ERROR) return propagate_error(root);
+            if (check_number_operand(capacity) == EVAL_ERROR) return propagate_error(root);
 
-                const int func_ptr = hash_table.get_pointer(get_lchild(root));
-                int param = get_lchild(get_rchild(func_ptr));
-                int argument = get_rchild(root);
-                
-                // 모든 매개변수에 값 대입
-                int param_count = 0, argument_count = 0;
-                while (param != 0 && argument != 0) {
-                    eval_func_stack.push(hash_table.get_hash_struct(get_lchild(param)));
-                    temp_arg_stack.push(hash_table.get_value(get_lchild(param)), eval(get_lchild(argument)));
-                    
-                    param = get_rchild(param);
-                    param_count++;
+            const double size = to_number(capacity);
+            if (size < 1 || size != std::floor(size)) {
+                return raise_error(root, Interpreter::WrongTypeError("a positive integer", get_output_string(capacity)));
+            }
 
-                    argument = get_rchild(argument);
-                    argument_count++;
-                }
+            return make_object(new Channel(static_cast<size_t>(size)));
 
-                // 인자와 매개변수의 개수가 서로 맞지 않을 때
-                if (param != 0 || argument != 0) {
-                    // 인자가 더 많을 경우
-                    while (param != 0) {
-                        param = get_rchild(param);
-                        param_count++;
-                    }
+        } else if (token_index == HashTable::symbol_name("channel-put")) {
+            // (channel-put channel value): 빈 자리가 생길 때까지 기다린 뒤 value를 넣음
+            const int argument = get_rchild(root);
+            const int params = count_params(root);
+            if (params != 2) {
+                return raise_error(root, Interpreter::InconsistentArguments(2, params));
+            }
 
-                    // 매개변수가 더 많을 경우
-                    while (argument != 0) {
-                        argument = get_rchild(argument);
-                        argument_count++;
-                    }
+            Channel* channel = eval_channel(root, get_lchild(argument));
+            if (channel == nullptr) return EVAL_ERROR;
+            const int value = eval(get_lchild(get_rchild(argument)));
+            if (value == EVAL_ERROR) return propagate_error(root);
 
-                    throw Interpreter::InconsistentArguments(param_count, argument_count);
-                }                
+            if (wait_on_channel(root, channel, false) == EVAL_ERROR) return EVAL_ERROR;
+            channel->put(value);
 
-                // 인자 계산이 끝난 후 함수 호출에 필요한 포인터 값 삽입
-                while (temp_arg_stack.size() >= 1) {
-                    hash_table.set_pointer(hash_table.get_hash_value(temp_arg_stack.top().symbol), temp_arg_stack.top().link_of_value);
-                    temp_arg_stack.pop();
-                }
+            int task = 0;
+            while ((task = channel->pop_getter()) != 0 && !wake_task(task)) {}
+            return value;
 
-                const int result = eval(get_lchild(get_rchild(get_rchild(hash_table.get_pointer(get_lchild(root))))));
+        } else if (token_index == HashTable::symbol_name("channel-get")) {
+            // (channel-get channel): 값이 들어올 때까지 기다린 뒤 꺼냄
+            const int params = count_params(root);
+            if (params != 1) {
+                return raise_error(root, Interpreter::InconsistentArguments(1, params));
+            }
 
-                // 함수 호출 전의 포인터 값으로 복원
-                while (eval_func_stack.size() >= 1) {
-                    hash_table.set_pointer(hash_table.get_hash_value(eval_func_stack.top().symbol), eval_func_stack.top().link_of_value);
-                    eval_func_stack.pop();
-                }
+            Channel* channel = eval_channel(root, get_lchild(get_rchild(root)));
+            if (channel == nullptr) return EVAL_ERROR;
 
-                return result;
+            if (wait_on_channel(root, channel, true) == EVAL_ERROR) return EVAL_ERROR;
+            const int value = channel->get();
 
-            } else {
-                throw Interpreter::UnknownIdentifier(token_index);
+            int task = 0;
+            while ((task = channel->pop_putter()) != 0 && !wake_task(task)) {}
+            return value;
+
+        } else if (hash_table.get_pointer(hash_table.get_hash_value(token_index)) != 0) {
+            // 사용자 정의 function / value
+            return call_procedure(root, get_lchild(root), hash_table.get_pointer(get_lchild(root)));
+
+        } else if (library_index.find(token_index) != nullptr) {
+            // require한 library의 함수: 처음 호출할 때 정의를 읽음
+            if (load_definition(root, get_lchild(root)) == EVAL_ERROR) return EVAL_ERROR;
+            if (hash_table.get_pointer(get_lchild(root)) == 0) {
+                return raise_error(root, Interpreter::UnknownIdentifier(token_index));
             }
-        } catch (Interpreter::InterpreterError& error) {
-            std::string curr_eval_call = "";
-            get_output(root, true, curr_eval_call);
-            error.stack_append(curr_eval_call);
+            return call_procedure(root, get_lchild(root), hash_table.get_pointer(get_lchild(root)));
+
+        } else if (macro_expander.is_macro(get_lchild(root))) {
+            // 전개되지 않은 macro: 맞는 pattern이 없음
+            return raise_error(root, Interpreter::BadSyntax(token_index));
 
-            throw error;
+        } else {
+            return raise_error(root, Interpreter::UnknownIdentifier(token_index));
         }
     }
 
@@ -893,8 +4752,6 @@ class Interpreter {
         std::cout << "Parse tree's root = " << parse_tree_root_ptr << "\n";
         std::cout << "\n";
 
-        const node_array_struct* tmp_node_array = node_array.get_node_array();
-        
         std::cout << "Node array: \n"
                   << std::string((max(length_of_int(node_array.get_size_parse_tree()) - 5, 0) + 1) / 2, ' ')
                   << "Index"
@@ -925,12 +4782,12 @@ class Interpreter {
                       << i << " | "
                       
                       << std::string(max(node_array.get_max_head_length(), 4) // 4 = length of "Head"
-                                     - length_of_int(tmp_node_array[i].head), ' ')
-                      << tmp_node_array[i].head << " | "
+                                     - length_of_int(node_array.at_head(i)), ' ')
+                      << node_array.at_head(i) << " | "
                       
                       << std::string(max(node_array.get_max_tail_length(), 4) // 4 = length of "Tail"
-                                     - length_of_int(tmp_node_array[i].tail), ' ')
-                      << tmp_node_array[i].tail
+                                     - length_of_int(node_array.at_tail(i)), ' ')
+                      << node_array.at_tail(i)
                       << "\n";
         }
         std::cout << "\n";
@@ -985,8 +4842,404 @@ class Interpreter {
         std::cout << output << "\n"; 
     }
 
+    void set_execution_mode(const ExecutionMode mode) {
+        execution_mode = mode;
+        compiled_lambdas.clear();
+        for (prepared_struct& form : prepared_forms) {
+            form.compiled.reset();
+        }
+    }
+
+    ExecutionMode get_execution_mode() const {
+        return execution_mode;
+    }
+
+    void set_eval_limits(const eval_limits_struct& limits) {
+        eval_limits = limits;
+    }
+
+    const eval_limits_struct& get_eval_limits() const {
+        return eval_limits;
+    }
+
+    // @param stream: write, newline 등 script의 기본 출력 대상. (기본값: std::cout)
+    void set_output_stream(std::ostream& stream) {
+        console_port.set_stream(stream);
+    }
+
+    // @param stream: GC 등 interpreter 상태 메시지를 출력할 곳. (기본값: std::cout)
+    void set_message_stream(std::ostream& stream) {
+        message_stream = &stream;
+    }
+
+    // @param path: 명령 읽기, 함수 호출, GC, symbol 추가를 기록해 종료할 때 쓸 Chrome trace file.
+    void set_trace_path(const std::string& path) {
+        trace_path = path;
+        tracer.enable();
+        hash_table.set_tracer(&tracer);
+    }
+
+    // root에서 도달할 수 있는 cell의 참조 graph를 path에 씀 (GC를 실행하지 않으므로 계산 도중에도 사용 가능)
+    // @return file을 썼는지의 여부.
+    bool dump_heap_snapshot(const std::string& path) const {
+        HeapSnapshot snapshot;
+        std::vector<int> pending;
+        const auto add_root = [&](const std::string& kind, const int hash, const int value) {
+            if (value > 0 && !node_array.is_arena(value)) {
+                snapshot.add_root(kind, (hash < 0) ? hash_table.get_value(hash) : "", value);
+                pending.push_back(value);
+            }
+        };
+
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            add_root("global", -i, hash_table.get_pointer(-i));
+        }
+        for (const std::pair<int, int>& binding : main_bindings) {
+            add_root("shadowed", binding.first, binding.second);
+        }
+        for (size_t i = 1; i < binding_snapshot.size(); i++) {
+            add_root("saved", -static_cast<int>(i), binding_snapshot[i]);
+        }
+        for (const int cell : running_generators) {
+            add_root("generator", 0, cell);
+        }
+        for (const int cell : live_tasks) {
+            add_root("task", 0, cell);
+        }
+        for (const int cell : active_continuations) {
+            add_root("continuation", 0, cell);
+        }
+        for (const prepared_struct& form : prepared_forms) {
+            add_root("prepared", 0, form.root);
+        }
+
+        // 각 cell을 한 번씩 방문하며 참조하는 cell을 기록
+        std::vector<bool> visited(NodeArray::TOTAL_SIZE, false);
+        std::vector<int> values, edges;
+        while (!pending.empty()) {
+            const int cell = pending.back();
+            pending.pop_back();
+            if (visited[cell]) continue;
+            visited[cell] = true;
+
+            values.clear();
+            std::string type = "pair";
+            size_t size = sizeof(node_array_struct);
+            const HeapObject* object = get_object(cell);
+            if (object != nullptr) {
+                type = object->type_name();
+                size += object->heap_size();
+                object->trace(values);
+            } else {
+                values.push_back(get_lchild(cell));
+                values.push_back(get_rchild(cell));
+            }
+
+            edges.clear();
+            for (const int value : values) {
+                if (value > 0 && !node_array.is_arena(value)) {
+                    edges.push_back(value);
+                    pending.push_back(value);
+                }
+            }
+            snapshot.add_node(cell, type, size, edges);
+        }
+
+        return snapshot.dump(path);
+    }
+
+    // @return trace file을 썼는지의 여부. (tracing 중이 아니면 false)
+    bool dump_trace() const {
+        if (!tracer.is_enabled()) {
+            return false;
+        }
+
+        return tracer.dump(trace_path, [this](const int symbol) { return hash_table.get_value(symbol); });
+    }
+
+    ~Interpreter() {
+        abort_suspended_generators();
+        if (tracer.is_enabled() && !dump_trace()) {
+            std::cerr << "Cannot write trace file: " << trace_path << "\n";
+        }
+    }
+
+    /* 전역 binding snapshot
+     * save_bindings() 당시의 전역 binding과 macro 정의를 restore_bindings()로 되돌린다.
+     * 저장한 값은 GC root로 보존되므로 그 사이에 다시 정의되어도 복원할 수 있다.
+     * 복원한 뒤에는 GC를 수행해 그 사이에 추가되었지만 더 이상 묶여 있지 않은 symbol과 cell을 회수한다.
+     */
+    void save_bindings() {
+        binding_snapshot.assign(HashTable::HASH_TABLE_SIZE, 0);
+        snapshot_symbols.assign(HashTable::HASH_TABLE_SIZE, false);
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            binding_snapshot[i] = hash_table.get_pointer(-i);
+            snapshot_symbols[i] = hash_table.get_value(-i) != "";
+        }
+        macro_expander.save_macros();
+    }
+
+    void restore_bindings() {
+        if (binding_snapshot.empty()) {
+            return;
+        }
+
+        for (int i = 1; i < HashTable::HASH_TABLE_SIZE; i++) {
+            hash_table.set_pointer(-i, binding_snapshot[i]);
+
+            // 복원된 lambda와 다른 lambda의 변환 결과는 버림 (snapshot의 lambda는 유지)
+            const auto compiled = compiled_lambdas.find(-i);
+            if (compiled != compiled_lambdas.end() && compiled->second.lambda_ptr != binding_snapshot[i]) {
+                compiled_lambdas.erase(compiled);
+            }
+            const auto jit = jit_lambdas.find(-i);
+            if (jit != jit_lambdas.end() && jit->second.lambda_ptr != binding_snapshot[i]) {
+                jit_lambdas.erase(jit);
+            }
+        }
+        macro_expander.restore_macros();
+        reset_reader();
+        collect_garbage(0, true);
+    }
+
+    /* 준비된 식 (내장 API: scheme.h)
+     * 식을 한 번만 읽고 macro를 전개해 main heap에 두고 (GC root), 계산할 때마다 매개변수 symbol을 인자 값에 묶어 다시 계산한다.
+     * 문자열 전처리, tokenize, parse를 반복하지 않으며, CLOSURE_COMPILED mode에서는 처음 계산할 때 변환한 functor tree를 재사용한다.
+     * 매개변수는 lambda와 같이 hash table에 직접 묶었다가 계산이 끝나면 이전 값으로 되돌린다.
+     * 결과는 출력하지 않고 SchemeValue로 복사해 돌려준다.
+     */
+    private:
+    struct prepared_struct {
+        bool is_used = false;
+        int root = 0;            // parse tree (main heap)
+        std::vector<int> params; // 매개변수 symbol의 hash 값
+        std::shared_ptr<const CompiledExpr> compiled;
+    };
+
+    std::vector<prepared_struct> prepared_forms; // index: handle
+
+    static bool is_balanced(const std::string& text) {
+        int depth = 0;
+        bool in_string = false, escaped = false;
+        for (const char c : text) {
+            if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                }
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '(') {
+                depth++;
+            } else if (c == ')' && --depth < 0) {
+                return false;
+            }
+        }
+
+        return depth == 0 && !in_string;
+    }
+
+    // @return host가 넘긴 인자를 나타내는 scheme 값.
+    int make_value(const int root, const SchemeValue& value) {
+        switch (value.get_type()) {
+        case SchemeValue::Type::NIL:
+            return 0;
+        case SchemeValue::Type::BOOLEAN:
+            return hash_table.get_hash_value(value.is_true() ? "#t" : "#f");
+        case SchemeValue::Type::NUMBER:
+            return make_number(value.get_number());
+        case SchemeValue::Type::STRING:
+            return make_object(new StringObject(value.get_text()));
+        case SchemeValue::Type::SYMBOL:
+            return hash_table.get_hash_value(value.get_text());
+        default: // OTHER: write 형식의 datum
+            if (!is_balanced(value.get_text())) {
+                return raise_error(root, Interpreter::BadSyntax(value.get_text()));
+            }
+            return parse_datum(value.get_text());
+        }
+    }
+
+    // @return 계산 결과를 복사한 값. (결과의 cell은 다음 GC에 회수될 수 있음)
+    SchemeValue to_scheme_value(const int value) const {
+        if (value == 0) {
+            return SchemeValue::make_nil();
+        } else if (value < 0) {
+            if (hash_table.is_number(value)) {
+                return SchemeValue::make_number(hash_table.get_number(value));
+            }
+
+            const std::string& name = hash_table.get_value(value);
+            if (name == "#t" || name == "#f") {
+                return SchemeValue::make_boolean(name == "#t");
+            }
+            return SchemeValue::make_symbol(name);
+        }
+
+        const StringObject* string = get_string(value);
+        if (string != nullptr) {
+            return SchemeValue::make_string(string->get());
+        }
+        return SchemeValue::make_other(get_output_string(value));
+    }
+
+    std::string pending_error_message() const {
+        std::string message = format_error(pending_error);
+        message.erase(message.find_last_not_of(" \n") + 1);
+        return message;
+    }
+
+    public:
+    // @param text: 식 하나의 원문.
+    // @param params: 계산할 때마다 인자 값을 묶을 매개변수 이름.
+    // @param error: 식을 읽을 수 없으면 그 이유를 저장할 곳.
+    // @return 준비된 식의 handle. 읽을 수 없으면 -1.
+    int prepare(const std::string& text, const std::vector<std::string>& params, std::string& error) {
+        if (text.find_first_not_of(" \t\r\n") == std::string::npos || !is_balanced(text)) {
+            error = "SchemeError: incomplete expression";
+            return -1;
+        }
+
+        prepared_struct form;
+        form.is_used = true;
+        bool is_whole = false;
+        try {
+            // 읽는 도중 GC가 일어나면 읽던 parse tree는 회수되므로 한 번 더 읽음
+            try {
+                form.root = parse_form(text, &is_whole);
+            } catch (const Interpreter::GarbageCollectionPerformed&) {
+                garbage_collection_count = 0;
+                form.root = parse_form(text, &is_whole);
+            }
+
+            // 매개변수 symbol은 GC가 지울 수 있으므로 다 읽은 뒤에 추가
+            for (std::string param : params) {
+                for (char& c : param) { // 식과 같이 소문자로 읽음 (preprocessing)
+                    if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+                }
+                form.params.push_back(hash_table.get_hash_value(param));
+            }
+        } catch (const Interpreter::GarbageCollectionPerformed&) {
+            garbage_collection_count = 0;
+            error = Interpreter::OutOfMemory("the expression is too large for the node array").what();
+            return -1;
+        } catch (const std::length_error& e) {
+            garbage_collection_count = 0;
+            error = Interpreter::OutOfMemory(e.what()).what();
+            return -1;
+        }
+        if (!is_whole) {
+            error = "SchemeError: expected a single expression";
+            return -1;
+        }
+
+        for (size_t i = 0; i < prepared_forms.size(); i++) {
+            if (!prepared_forms[i].is_used) {
+                prepared_forms[i] = form;
+                return static_cast<int>(i);
+            }
+        }
+        prepared_forms.push_back(form);
+        return static_cast<int>(prepared_forms.size() - 1);
+    }
+
+    // handle을 더 이상 사용하지 않음 (parse tree는 다음 GC에 회수)
+    void release_prepared(const int handle) {
+        if (handle >= 0 && handle < static_cast<int>(prepared_forms.size())) {
+            prepared_forms[handle] = prepared_struct();
+        }
+    }
+
+    // @param args: params 순서의 인자 값.
+    // @param result: 계산 결과를 저장할 곳.
+    // @param error: 오류 메시지를 저장할 곳.
+    // @return 오류 없이 계산했는지의 여부.
+    bool eval_prepared(const int handle, const std::vector<SchemeValue>& args, SchemeValue& result, std::string& error) {
+        if (handle < 0 || handle >= static_cast<int>(prepared_forms.size()) || !prepared_forms[handle].is_used) {
+            error = "SchemeError: unknown prepared expression " + std::to_string(handle);
+            return false;
+        }
+        if (args.size() != prepared_forms[handle].params.size()) {
+            pending_error = Interpreter::InconsistentArguments(prepared_forms[handle].params.size(), args.size());
+            error = pending_error_message();
+            return false;
+        }
+
+        const int value = run_command([this, handle, &args]() {
+            collect_garbage_between_commands();
+
+            prepared_struct& form = prepared_forms[handle];
+            BindingStack& bindings = *dynamic_bindings;
+            const size_t binding_mark = bindings.size();
+            int value = 0;
+            try {
+                for (size_t i = 0; i < args.size(); i++) {
+                    value = make_value(form.root, args[i]);
+                    if (value == EVAL_ERROR) break;
+                    bind_dynamic(form.params[i], value);
+                }
+
+                if (value == EVAL_ERROR) {
+                    // 인자 오류
+                } else if (execution_mode == ExecutionMode::CLOSURE_COMPILED) {
+                    if (!form.compiled) {
+                        form.compiled = std::make_shared<const CompiledExpr>(compile(form.root));
+                    }
+                    value = (*form.compiled)();
+                } else {
+                    value = eval(form.root);
+                }
+            } catch (...) {
+                unbind_dynamic(bindings, binding_mark);
+                throw;
+            }
+            unbind_dynamic(bindings, binding_mark);
+
+            return value;
+        });
+
+        if (value == EVAL_ERROR) {
+            error = pending_error_message();
+            return false;
+        }
+        result = to_scheme_value(value);
+        return true;
+    }
+
+    // quote된 data의 hash-consing 사용 여부
+    void set_hash_consing_enabled(const bool enabled) {
+        hash_consing_enabled = enabled;
+        hash_cons_table.clear();
+        hash_consed_strings.clear();
+    }
+
+    // @return JIT를 사용할 수 있는지의 여부. (Linux x86-64 전용)
+    bool set_jit_enabled(const bool enabled) {
+        jit_enabled = enabled && SCHEME_JIT_AVAILABLE;
+        jit_lambdas.clear();
+        return jit_enabled == enabled;
+    }
+
     void init() {
+        abort_suspended_generators();
         node_array.free();
+        heap_objects.clear();
+        library_index.clear();
+        hash_cons_table.clear();
+        hash_consed_strings.clear();
+        loop_lambdas.clear();
+        binding_snapshot.clear();
+        snapshot_symbols.clear();
+        main_bindings.clear();
+        active_continuations.clear();
+        ready_tasks.clear();
+        live_tasks.clear();
+        prepared_forms.clear();
+        free_cells_after_gc = NodeArray::NODE_ARRAY_SIZE;
+        free_symbols_after_gc = HashTable::HASH_TABLE_SIZE;
         
         input_str = "";
         input_str_read_ptr = 0;
@@ -0,0 +1,354 @@
+#ifndef JIT_X86_64_H
+#define JIT_X86_64_H
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SCHEME_JIT_AVAILABLE 1
+#else
+#define SCHEME_JIT_AVAILABLE 0
+#endif
+
+/* 숫자 lambda용 baseline JIT
+ * Interpreter가 lambda 본문을 jit_expr_struct tree로 바꿔 넘기면
+ * x86-64 기계어(SSE2 double 연산)로 변환하여 실행 가능한 메모리에 올린다.
+ *
+ * 생성된 함수: int f(const double* args, double* result)
+ *  - 0을 반환하면 *result에 결과가 들어 있다.
+ *  - 1을 반환하면 guard 실패: interpreter가 처음부터 다시 계산해야 한다.
+ *    (변환 대상은 부수 효과가 없는 식뿐이므로 다시 계산해도 결과가 같다.)
+ *  - 계산 단계(JitFunction::fuel())나 호출 깊이(JitFunction::depth_left())를 모두 사용해도 guard 실패로 빠져나오므로
+ *    interpreter가 다시 계산하면서 한도 초과 오류를 낸다.
+ */
+
+struct jit_expr_struct {
+    enum Kind {
+        CONSTANT,
+        PARAM,
+        ADD, SUB, MUL, DIV,  // operands: lhs, rhs
+        LESS, GREATER, EQUAL, // operands: lhs, rhs (cond의 조건으로만 사용)
+        COND,                 // operands: test0, body0, test1, body1, ..., else_body
+        SELF_CALL             // operands: 인자
+    };
+
+    Kind kind = CONSTANT;
+    double constant = 0.0;
+    int param_index = 0;
+    std::vector<jit_expr_struct> operands;
+};
+
+class JitFunction {
+    public:
+    typedef int (*EntryPoint)(const double* args, double* result);
+
+    // 중첩 호출 깊이 제한: 생성된 코드는 rsp가 이 값보다 작아지면 guard 실패로 빠져나옴
+    static std::uintptr_t& stack_limit() {
+        static std::uintptr_t limit = 0;
+        return limit;
+    }
+
+    // 남은 계산 단계: 생성된 코드는 호출될 때마다 1씩 감소시키고 음수가 되면 guard 실패로 빠져나옴
+    static std::int64_t& fuel() {
+        static std::int64_t steps = INT64_MAX;
+        return steps;
+    }
+
+    // 남은 호출 깊이: 생성된 코드는 들어갈 때 1 감소, 나올 때 1 증가시키고 음수가 되면 guard 실패로 빠져나옴
+    static std::int64_t& depth_left() {
+        static std::int64_t depth = INT64_MAX;
+        return depth;
+    }
+
+    private:
+    void* code = nullptr;
+    std::size_t code_size = 0;
+
+    public:
+    JitFunction() = default;
+    JitFunction(const JitFunction&) = delete;
+    JitFunction& operator=(const JitFunction&) = delete;
+
+    ~JitFunction() {
+#if SCHEME_JIT_AVAILABLE
+        if (code != nullptr) {
+            munmap(code, code_size);
+        }
+#endif
+    }
+
+    // @param bytes: 생성된 기계어.
+    // @return 실행 가능한 메모리에 올렸는지의 여부.
+    bool load(const std::vector<unsigned char>& bytes) {
+#if SCHEME_JIT_AVAILABLE
+        const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        code_size = (bytes.size() + page_size - 1) / page_size * page_size;
+
+        void* memory = mmap(nullptr, code_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            code_size = 0;
+            return false;
+        }
+        std::memcpy(memory, bytes.data(), bytes.size());
+
+        // W^X: 쓰기가 끝난 후 실행 권한으로 전환
+        if (mprotect(memory, code_size, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, code_size);
+            code_size = 0;
+            return false;
+        }
+
+        code = memory;
+        return true;
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    bool is_loaded() const {
+        return code != nullptr;
+    }
+
+    // @return 0: 성공, 1: guard 실패.
+    int call(const double* args, double* result) const {
+        // 현재 native stack에서 256KiB까지만 사용
+        char stack_marker = 0;
+        std::uintptr_t& limit = stack_limit();
+        const std::uintptr_t orig_limit = limit;
+        limit = reinterpret_cast<std::uintptr_t>(&stack_marker) - 256 * 1024;
+
+        EntryPoint entry = reinterpret_cast<EntryPoint>(code);
+        const int status = entry(args, result);
+
+        limit = orig_limit;
+        return status;
+    }
+};
+
+class JitCompiler {
+    private:
+    std::vector<unsigned char> bytes;
+    std::vector<std::size_t> bail_patches; // guard 실패 시 bail label로 가는 rel32 위치
+
+    void emit(std::initializer_list<unsigned char> code) {
+        bytes.insert(bytes.end(), code.begin(), code.end());
+    }
+
+    void emit_int32(const std::int32_t value) {
+        unsigned char buffer[4];
+        std::memcpy(buffer, &value, 4);
+        bytes.insert(bytes.end(), buffer, buffer + 4);
+    }
+
+    void emit_int64(const std::int64_t value) {
+        unsigned char buffer[8];
+        std::memcpy(buffer, &value, 8);
+        bytes.insert(bytes.end(), buffer, buffer + 8);
+    }
+
+    // @return 나중에 채울 rel32의 위치.
+    std::size_t emit_jump(std::initializer_list<unsigned char> opcode) {
+        emit(opcode);
+        const std::size_t patch = bytes.size();
+        emit_int32(0);
+        return patch;
+    }
+
+    void emit_bail_jump(std::initializer_list<unsigned char> opcode) {
+        bail_patches.push_back(emit_jump(opcode));
+    }
+
+    void patch_jump(const std::size_t patch, const std::size_t target) {
+        const std::int32_t rel = static_cast<std::int32_t>(target) - static_cast<std::int32_t>(patch + 4);
+        std::memcpy(&bytes[patch], &rel, 4);
+    }
+
+    void emit_push_xmm0() {
+        emit({0x48, 0x81, 0xEC}); emit_int32(16);     // sub rsp, 16
+        emit({0xF2, 0x0F, 0x11, 0x04, 0x24});         // movsd [rsp], xmm0
+    }
+
+    // 왼쪽 피연산자 -> xmm0, 오른쪽 피연산자 -> xmm1
+    void emit_operands(const jit_expr_struct& expr) {
+        emit_expr(expr.operands[0]);
+        emit_push_xmm0();
+        emit_expr(expr.operands[1]);
+        emit({0x66, 0x0F, 0x28, 0xC8});               // movapd xmm1, xmm0
+        emit({0xF2, 0x0F, 0x10, 0x04, 0x24});         // movsd xmm0, [rsp]
+        emit({0x48, 0x81, 0xC4}); emit_int32(16);     // add rsp, 16
+    }
+
+    // interpreter의 숫자 symbol은 double 값을 그대로 나타내므로 (Numeric::format) 연산 결과도 그대로 사용할 수 있음
+    // NaN과 -0만 interpreter의 =(같은 symbol인지 비교)와 결과가 다르므로 통과시키지 않음
+    void emit_result_guard() {
+        emit({0x66, 0x0F, 0x2E, 0xC0});               // ucomisd xmm0, xmm0
+        emit_bail_jump({0x0F, 0x8A});                 // jp bail (NaN)
+
+        const std::int64_t negative_zero = std::numeric_limits<std::int64_t>::min();
+        emit({0x66, 0x48, 0x0F, 0x7E, 0xC0});         // movq rax, xmm0
+        emit({0x48, 0xBA}); emit_int64(negative_zero); // mov rdx, -0의 bit
+        emit({0x48, 0x39, 0xD0});                     // cmp rax, rdx
+        emit_bail_jump({0x0F, 0x84});                 // je bail
+    }
+
+    // 조건이 거짓이면 이동하는 jump의 rel32 위치를 반환
+    std::size_t emit_test(const jit_expr_struct& test) {
+        emit_operands(test);
+        emit({0x66, 0x0F, 0x2E, 0xC1});               // ucomisd xmm0, xmm1
+
+        switch (test.kind) {
+        case jit_expr_struct::LESS:
+            return emit_jump({0x0F, 0x83});           // jae false
+        case jit_expr_struct::GREATER:
+            return emit_jump({0x0F, 0x86});           // jbe false
+        default: // EQUAL
+            return emit_jump({0x0F, 0x85});           // jne false
+        }
+    }
+
+    // 결과는 xmm0
+    void emit_expr(const jit_expr_struct& expr) {
+        switch (expr.kind) {
+        case jit_expr_struct::CONSTANT: {
+            std::int64_t bits;
+            std::memcpy(&bits, &expr.constant, 8);
+            emit({0x48, 0xB8}); emit_int64(bits);     // mov rax, imm64
+            emit({0x66, 0x48, 0x0F, 0x6E, 0xC0});     // movq xmm0, rax
+            break;
+        }
+
+        case jit_expr_struct::PARAM:
+            emit({0xF2, 0x0F, 0x10, 0x83});           // movsd xmm0, [rbx + disp32]
+            emit_int32(expr.param_index * 8);
+            break;
+
+        case jit_expr_struct::ADD:
+        case jit_expr_struct::SUB:
+        case jit_expr_struct::MUL:
+        case jit_expr_struct::DIV: {
+            emit_operands(expr);
+            const unsigned char opcode = (expr.kind == jit_expr_struct::ADD) ? 0x58 :
+                                         (expr.kind == jit_expr_struct::SUB) ? 0x5C :
+                                         (expr.kind == jit_expr_struct::MUL) ? 0x59 : 0x5E;
+            emit({0xF2, 0x0F, opcode, 0xC1});         // op xmm0, xmm1
+            emit_result_guard();
+            break;
+        }
+
+        case jit_expr_struct::COND: {
+            std::vector<std::size_t> end_patches;
+            const std::size_t clauses = expr.operands.size() / 2;
+            for (std::size_t i = 0; i < clauses; i++) {
+                const std::size_t next = emit_test(expr.operands[i * 2]);
+                emit_expr(expr.operands[i * 2 + 1]);
+                end_patches.push_back(emit_jump({0xE9})); // jmp end
+                patch_jump(next, bytes.size());
+            }
+            emit_expr(expr.operands.back());          // else
+            for (const std::size_t patch : end_patches) {
+                patch_jump(patch, bytes.size());
+            }
+            break;
+        }
+
+        case jit_expr_struct::SELF_CALL: {
+            // 인자 배열과 결과 자리를 stack에 확보 (16 byte 정렬 유지)
+            const std::int32_t arg_bytes = static_cast<std::int32_t>(expr.operands.size()) * 8;
+            const std::int32_t frame = (arg_bytes + 8 + 15) / 16 * 16;
+            emit({0x48, 0x81, 0xEC}); emit_int32(frame);  // sub rsp, frame
+
+            for (std::size_t i = 0; i < expr.operands.size(); i++) {
+                emit_expr(expr.operands[i]);
+                emit({0xF2, 0x0F, 0x11, 0x84, 0x24}); // movsd [rsp + disp32], xmm0
+                emit_int32(static_cast<std::int32_t>(i) * 8);
+            }
+
+            emit({0x48, 0x8D, 0x3C, 0x24});           // lea rdi, [rsp]
+            emit({0x48, 0x8D, 0xB4, 0x24});           // lea rsi, [rsp + disp32]
+            emit_int32(arg_bytes);
+            const std::size_t call = emit_jump({0xE8}); // call self
+            patch_jump(call, 0);
+            emit({0x85, 0xC0});                       // test eax, eax
+            emit_bail_jump({0x0F, 0x85});             // jnz bail
+
+            emit({0xF2, 0x0F, 0x10, 0x84, 0x24});     // movsd xmm0, [rsp + disp32]
+            emit_int32(arg_bytes);
+            emit({0x48, 0x81, 0xC4}); emit_int32(frame);  // add rsp, frame
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    public:
+    // @param body: 숫자 결과를 내는 lambda 본문.
+    // @param function: 생성한 코드를 올릴 대상.
+    // @return 성공 여부.
+    bool compile(const jit_expr_struct& body, JitFunction& function) {
+        bytes.clear();
+        bail_patches.clear();
+
+        // prologue
+        emit({0x55});                                 // push rbp
+        emit({0x48, 0x89, 0xE5});                     // mov rbp, rsp
+        emit({0x53});                                 // push rbx
+        emit({0x41, 0x54});                           // push r12
+        emit({0x48, 0x89, 0xFB});                     // mov rbx, rdi (args)
+        emit({0x49, 0x89, 0xF4});                     // mov r12, rsi (result)
+
+        // 호출 깊이 guard: 이후 모든 경로가 epilogue에서 다시 1 증가
+        emit({0x48, 0xB8});                           // mov rax, &depth_left
+        emit_int64(static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(&JitFunction::depth_left())));
+        emit({0x48, 0x83, 0x28, 0x01});               // sub qword [rax], 1
+        emit_bail_jump({0x0F, 0x88});                 // js bail
+
+        // stack 깊이 guard
+        emit({0x48, 0xB8});                           // mov rax, &stack_limit
+        emit_int64(static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(&JitFunction::stack_limit())));
+        emit({0x48, 0x3B, 0x20});                     // cmp rsp, [rax]
+        emit_bail_jump({0x0F, 0x82});                 // jb bail
+
+        // 계산 단계 guard
+        emit({0x48, 0xB8});                           // mov rax, &fuel
+        emit_int64(static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(&JitFunction::fuel())));
+        emit({0x48, 0x83, 0x28, 0x01});               // sub qword [rax], 1
+        emit_bail_jump({0x0F, 0x88});                 // js bail
+
+        emit_expr(body);
+
+        emit({0xF2, 0x41, 0x0F, 0x11, 0x04, 0x24});   // movsd [r12], xmm0
+        emit({0x31, 0xC0});                           // xor eax, eax
+        const std::size_t done = emit_jump({0xE9});   // jmp epilogue
+
+        // bail
+        const std::size_t bail = bytes.size();
+        emit({0xB8}); emit_int32(1);                  // mov eax, 1
+        for (const std::size_t patch : bail_patches) {
+            patch_jump(patch, bail);
+        }
+
+        // epilogue
+        patch_jump(done, bytes.size());
+        emit({0x48, 0xBA});                           // mov rdx, &depth_left
+        emit_int64(static_cast<std::int64_t>(reinterpret_cast<std::uintptr_t>(&JitFunction::depth_left())));
+        emit({0x48, 0x83, 0x02, 0x01});               // add qword [rdx], 1
+        emit({0x48, 0x8D, 0x65, 0xF0});               // lea rsp, [rbp - 16]
+        emit({0x41, 0x5C});                           // pop r12
+        emit({0x5B});                                 // pop rbx
+        emit({0x5D});                                 // pop rbp
+        emit({0xC3});                                 // ret
+
+        return function.load(bytes);
+    }
+};
+
+#endif
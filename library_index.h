@@ -0,0 +1,191 @@
+#ifndef LIBRARY_INDEX_H
+#define LIBRARY_INDEX_H
+
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "hash_table.h"
+
+/* require한 library file의 색인
+ * file을 한 번 훑으며 최상위 식의 위치(byte offset, 길이)만 기록하고 본문은 읽지 않는다.
+ *  - (define name ...), (define (name ...) ...): 이름으로 색인해 두고 처음 쓰일 때 그 식만 읽음
+ *  - 그 외의 식 (define-syntax, 다른 require 등): require할 때 순서대로 계산하도록 돌려줌
+ * ';'부터 줄 끝까지는 주석이다.
+ */
+class LibraryIndex {
+    public:
+    struct form_struct {
+        std::string path = "";
+        std::streamoff offset = 0;
+        size_t length = 0;
+    };
+
+    private:
+    std::unordered_map<std::string, form_struct> definitions; // key: hash table에 저장되는 symbol 이름
+    std::unordered_set<std::string> indexed_paths;
+
+    static bool is_delimiter(const int c) {
+        return c == '(' || c == ')' || c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ';' || c == '"';
+    }
+
+    static std::string read_token(const std::string& text, size_t& pos) {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r')) {
+            pos++;
+        }
+
+        std::string token = "";
+        while (pos < text.size() && !is_delimiter(text[pos])) {
+            char c = text[pos++];
+            if (c >= 'A' && c <= 'Z') { // interpreter와 같이 소문자로
+                c += 'a' - 'A';
+            }
+            token += c;
+        }
+        return token;
+    }
+
+    // @param head: 식의 앞부분.
+    // @return define한 이름. (define이 아니면 "")
+    static std::string defined_name(const std::string& head) {
+        size_t pos = 1; // '('
+        if (read_token(head, pos) != "define") {
+            return "";
+        }
+
+        while (pos < head.size() && (head[pos] == ' ' || head[pos] == '\t' || head[pos] == '\n' || head[pos] == '\r')) {
+            pos++;
+        }
+        if (pos < head.size() && head[pos] == '(') { // (define (name param ...) body)
+            pos++;
+        }
+        return HashTable::symbol_name(read_token(head, pos));
+    }
+
+    public:
+    static const size_t HEAD_SIZE = 64; // 이름을 찾기 위해 보관하는 식의 앞부분 길이
+
+    // @param path: library file 경로.
+    // @param eager_forms: 바로 계산할 최상위 식을 추가할 곳.
+    // @return file을 열 수 있었는지의 여부.
+    bool index_file(const std::string& path, std::vector<form_struct>& eager_forms) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            return false;
+        }
+        indexed_paths.insert(path);
+
+        std::streamoff offset = 0, start = 0;
+        std::string head = "";
+        int depth = 0;
+        bool in_string = false, escaped = false, in_comment = false;
+
+        int c = 0;
+        while ((c = file.get()) != EOF) {
+            offset++;
+            if (depth > 0 && head.size() < HEAD_SIZE) {
+                head += static_cast<char>(c);
+            }
+
+            if (in_comment) {
+                if (c == '\n') in_comment = false;
+            } else if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                }
+            } else if (c == ';') {
+                in_comment = true;
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '(') {
+                if (depth++ == 0) {
+                    start = offset - 1;
+                    head = "(";
+                }
+            } else if (c == ')' && depth > 0) {
+                if (--depth == 0) {
+                    form_struct form;
+                    form.path = path;
+                    form.offset = start;
+                    form.length = static_cast<size_t>(offset - start);
+
+                    const std::string name = defined_name(head);
+                    if (name != "") {
+                        definitions[name] = form;
+                    } else {
+                        eager_forms.push_back(form);
+                    }
+                }
+            }
+        }
+
+        return true;
+    }
+
+    bool is_indexed(const std::string& path) const {
+        return indexed_paths.count(path) != 0;
+    }
+
+    bool empty() const {
+        return definitions.empty();
+    }
+
+    // @param name: hash table에 저장된 symbol 이름.
+    // @return name을 정의하는 식. (없으면 nullptr)
+    const form_struct* find(const std::string& name) const {
+        const std::unordered_map<std::string, form_struct>::const_iterator found = definitions.find(name);
+        return (found != definitions.end()) ? &found->second : nullptr;
+    }
+
+    // @param text: 읽은 식을 저장할 곳. (주석 제외)
+    // @return file에서 식을 읽었는지의 여부.
+    static bool read_form(const form_struct& form, std::string& text) {
+        std::ifstream file(form.path, std::ios::binary);
+        if (!file.seekg(form.offset)) {
+            return false;
+        }
+
+        std::string raw(form.length, '\0');
+        if (!file.read(&raw[0], static_cast<std::streamsize>(form.length))) {
+            return false;
+        }
+
+        text = "";
+        bool in_string = false, escaped = false, in_comment = false;
+        for (const char c : raw) {
+            if (in_comment) {
+                if (c != '\n') continue;
+                in_comment = false;
+            } else if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                }
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == ';') {
+                in_comment = true;
+                continue;
+            }
+            text += c;
+        }
+
+        return true;
+    }
+
+    void clear() {
+        definitions.clear();
+        indexed_paths.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,458 @@
+#ifndef MACRO_EXPANDER_H
+#define MACRO_EXPANDER_H
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "node_array.h"
+#include "hash_table.h"
+
+/* parse tree 단계의 macro 전개기
+ * 읽어 들인 식 하나를 eval하기 전에 한 번만 전개한다.
+ *  - (define (f x) ...)    => (define f (lambda (x) ...))
+ *  - (define-syntax name (syntax-rules (literal ...) (pattern template) ...))
+ *    정의할 때 pattern과 template을 syntax_pattern_struct로 변환해 두므로
+ *    macro를 사용할 때마다 정의의 parse tree를 다시 해석하지 않는다.
+ * 전개 결과는 parse tree를 직접 고쳐 쓰므로 lambda 본문 등에 저장된 뒤에는 다시 전개되지 않는다.
+ *
+ * 위생(hygiene): template이 lambda, let, let*, do로 새로 묶는 이름은
+ * macro마다 고유한 이름(예: tmp%3)으로 바꾸어 사용자의 변수와 겹치지 않게 한다.
+ */
+class MacroExpander {
+    private:
+    struct syntax_pattern_struct {
+        int symbol = 0;            // list가 아닐 때의 hash 값 (0: ())
+        bool is_list = false;
+        bool has_ellipsis = false; // 바로 뒤에 ...이 있는지의 여부
+        std::vector<syntax_pattern_struct> items;
+    };
+
+    struct syntax_rule_struct {
+        syntax_pattern_struct pattern;
+        syntax_pattern_struct template_;
+    };
+
+    struct macro_struct {
+        std::vector<int> literals;
+        std::vector<syntax_rule_struct> rules;
+        std::unordered_map<int, int> renames; // template이 새로 묶는 이름 -> 고유한 이름
+    };
+
+    struct syntax_binding_struct {
+        int value = 0;
+        bool is_sequence = false; // ...로 반복된 pattern 변수
+        std::vector<syntax_binding_struct> items;
+    };
+
+    typedef std::unordered_map<int, syntax_binding_struct> SyntaxBindings;
+
+    NodeArray& node_array;
+    HashTable& hash_table;
+    std::function<int()> alloc;
+
+    std::unordered_map<int, macro_struct> macros; // key: macro 이름의 hash 값
+    std::unordered_map<int, macro_struct> saved_macros;
+    int rename_count = 0;
+
+    int symbol(const std::string& name) {
+        return hash_table.get_hash_value(name);
+    }
+
+    bool is_symbol(const int value, const std::string& name) const {
+        return value < 0 && hash_table.get_value(value) == HashTable::symbol_name(name);
+    }
+
+    // @param values: list의 원소.
+    // @return 새로 만든 list의 root node 포인터.
+    int make_list(const std::vector<int>& values) {
+        int root_ptr = 0, temp_ptr = 0;
+        for (const int value : values) {
+            const int new_ptr = alloc();
+            node_array.set_head(new_ptr, value);
+            node_array.set_tail(new_ptr, 0);
+
+            if (root_ptr == 0) {
+                root_ptr = new_ptr;
+            } else {
+                node_array.set_tail(temp_ptr, new_ptr);
+            }
+            temp_ptr = new_ptr;
+        }
+
+        return root_ptr;
+    }
+
+    syntax_pattern_struct parse_pattern(const int root) {
+        syntax_pattern_struct pattern;
+        if (root <= 0 || node_array.is_object(root)) { // symbol, (), 문자열 literal 등
+            pattern.symbol = root;
+            return pattern;
+        }
+
+        pattern.is_list = true;
+        for (int temp_ptr = root; temp_ptr != 0; temp_ptr = node_array.get_rchild(temp_ptr)) {
+            const int item = node_array.get_lchild(temp_ptr);
+            if (is_symbol(item, "...") && !pattern.items.empty()) {
+                pattern.items.back().has_ellipsis = true;
+            } else {
+                pattern.items.push_back(parse_pattern(item));
+            }
+        }
+
+        return pattern;
+    }
+
+    void trace_pattern(const syntax_pattern_struct& pattern, std::vector<int>& values) const {
+        values.push_back(pattern.symbol);
+        for (const syntax_pattern_struct& item : pattern.items) {
+            trace_pattern(item, values);
+        }
+    }
+
+    bool is_literal(const macro_struct& macro, const int value) const {
+        for (const int literal : macro.literals) {
+            if (literal == value) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool is_pattern_variable(const macro_struct& macro, const int value) const {
+        return value < 0 && !is_literal(macro, value) && !is_symbol(value, "_") &&
+               !hash_table.is_number(value);
+    }
+
+    void collect_pattern_variables(const macro_struct& macro, const syntax_pattern_struct& pattern, std::vector<int>& variables) const {
+        if (!pattern.is_list) {
+            if (is_pattern_variable(macro, pattern.symbol)) {
+                variables.push_back(pattern.symbol);
+            }
+            return;
+        }
+
+        for (const syntax_pattern_struct& item : pattern.items) {
+            collect_pattern_variables(macro, item, variables);
+        }
+    }
+
+    // template이 새로 묶는 이름을 찾아 고유한 이름을 붙임
+    void collect_renames(macro_struct& macro, const syntax_pattern_struct& template_, const std::vector<int>& variables) {
+        if (!template_.is_list || template_.items.empty()) {
+            return;
+        }
+
+        const int keyword = template_.items[0].symbol;
+        std::vector<const syntax_pattern_struct*> binders;
+
+        if (is_symbol(keyword, "lambda") && template_.items.size() >= 2) {
+            // (lambda (x ...) body)
+            for (const syntax_pattern_struct& param : template_.items[1].items) {
+                binders.push_back(&param);
+            }
+        } else if ((is_symbol(keyword, "let") || is_symbol(keyword, "let*") || is_symbol(keyword, "do")) &&
+                   template_.items.size() >= 2) {
+            // (let ((x init) ...) body), (let name ((x init) ...) body), (do ((x init step) ...) ...)
+            size_t bindings_index = 1;
+            if (is_symbol(keyword, "let") && !template_.items[1].is_list) {
+                binders.push_back(&template_.items[1]);
+                bindings_index = 2;
+            }
+            if (bindings_index < template_.items.size()) {
+                for (const syntax_pattern_struct& binding : template_.items[bindings_index].items) {
+                    if (binding.is_list && !binding.items.empty()) {
+                        binders.push_back(&binding.items[0]);
+                    }
+                }
+            }
+        }
+
+        for (const syntax_pattern_struct* binder : binders) {
+            const int name = binder->symbol;
+            if (binder->is_list || name >= 0 || macro.renames.count(name) != 0) continue;
+
+            bool is_variable = false;
+            for (const int variable : variables) {
+                if (variable == name) is_variable = true;
+            }
+            if (is_variable) continue;
+
+            // MAX_SYMBOL_SIZE 안에 들어가도록 원래 이름의 앞부분만 사용
+            const std::string suffix = "%" + std::to_string(++rename_count);
+            const std::string orig_name = hash_table.get_value(name);
+            const int prefix_size = HashTable::MAX_SYMBOL_SIZE - static_cast<int>(suffix.size());
+            macro.renames[name] = symbol(orig_name.substr(0, prefix_size > 0 ? prefix_size : 0) + suffix);
+        }
+
+        for (const syntax_pattern_struct& item : template_.items) {
+            collect_renames(macro, item, variables);
+        }
+    }
+
+    bool match(const macro_struct& macro, const syntax_pattern_struct& pattern, const int form, SyntaxBindings& bindings) const {
+        if (!pattern.is_list) {
+            if (is_symbol(pattern.symbol, "_")) {
+                return true;
+            }
+            if (pattern.symbol == 0) {
+                return form == 0;
+            }
+            if (is_pattern_variable(macro, pattern.symbol)) {
+                bindings[pattern.symbol].value = form;
+                return true;
+            }
+            return form == pattern.symbol; // literal, 숫자
+        }
+
+        if (form < 0 || node_array.is_object(form)) {
+            return false;
+        }
+
+        std::vector<int> elements;
+        for (int temp_ptr = form; temp_ptr != 0; temp_ptr = node_array.get_rchild(temp_ptr)) {
+            elements.push_back(node_array.get_lchild(temp_ptr));
+        }
+
+        size_t element_index = 0;
+        for (size_t i = 0; i < pattern.items.size(); i++) {
+            const syntax_pattern_struct& item = pattern.items[i];
+            if (!item.has_ellipsis) {
+                if (element_index >= elements.size() || !match(macro, item, elements[element_index], bindings)) {
+                    return false;
+                }
+                element_index++;
+                continue;
+            }
+
+            // ... 뒤에 남은 pattern이 필요로 하는 원소를 제외하고 모두 반복 부분에 대응
+            const size_t rest = pattern.items.size() - i - 1;
+            if (elements.size() < element_index + rest) {
+                return false;
+            }
+            const size_t repeat = elements.size() - element_index - rest;
+
+            std::vector<int> variables;
+            collect_pattern_variables(macro, item, variables);
+            for (const int variable : variables) {
+                bindings[variable].is_sequence = true;
+            }
+
+            for (size_t j = 0; j < repeat; j++) {
+                SyntaxBindings item_bindings;
+                if (!match(macro, item, elements[element_index + j], item_bindings)) {
+                    return false;
+                }
+                for (const int variable : variables) {
+                    bindings[variable].items.push_back(item_bindings[variable]);
+                }
+            }
+            element_index += repeat;
+        }
+
+        return element_index == elements.size();
+    }
+
+    void collect_sequence_variables(const syntax_pattern_struct& template_, const SyntaxBindings& bindings, std::vector<int>& variables) const {
+        if (!template_.is_list) {
+            const SyntaxBindings::const_iterator iter = bindings.find(template_.symbol);
+            if (iter != bindings.end() && iter->second.is_sequence) {
+                variables.push_back(template_.symbol);
+            }
+            return;
+        }
+
+        for (const syntax_pattern_struct& item : template_.items) {
+            collect_sequence_variables(item, bindings, variables);
+        }
+    }
+
+    int instantiate(const macro_struct& macro, const syntax_pattern_struct& template_, const SyntaxBindings& bindings) {
+        if (!template_.is_list) {
+            const SyntaxBindings::const_iterator binding = bindings.find(template_.symbol);
+            if (binding != bindings.end()) {
+                return binding->second.value;
+            }
+
+            const std::unordered_map<int, int>::const_iterator rename = macro.renames.find(template_.symbol);
+            if (rename != macro.renames.end()) {
+                return rename->second;
+            }
+            return template_.symbol;
+        }
+
+        std::vector<int> values;
+        for (const syntax_pattern_struct& item : template_.items) {
+            if (!item.has_ellipsis) {
+                values.push_back(instantiate(macro, item, bindings));
+                continue;
+            }
+
+            std::vector<int> variables;
+            collect_sequence_variables(item, bindings, variables);
+            if (variables.empty()) {
+                continue;
+            }
+
+            size_t repeat = bindings.at(variables[0]).items.size();
+            for (const int variable : variables) {
+                if (bindings.at(variable).items.size() < repeat) {
+                    repeat = bindings.at(variable).items.size();
+                }
+            }
+
+            for (size_t i = 0; i < repeat; i++) {
+                SyntaxBindings item_bindings = bindings;
+                for (const int variable : variables) {
+                    item_bindings[variable] = bindings.at(variable).items[i];
+                }
+                values.push_back(instantiate(macro, item, item_bindings));
+            }
+        }
+
+        return make_list(values);
+    }
+
+    // (define-syntax name (syntax-rules (literal ...) (pattern template) ...))
+    void define_syntax(const int root) {
+        const int name_ptr = node_array.get_rchild(root);
+        if (name_ptr == 0 || node_array.get_rchild(name_ptr) == 0) return;
+
+        const int name = node_array.get_lchild(name_ptr);
+        const int rules_form = node_array.get_lchild(node_array.get_rchild(name_ptr));
+        if (name >= 0 || rules_form <= 0 || !is_symbol(node_array.get_lchild(rules_form), "syntax-rules")) return;
+
+        const int literals_ptr = node_array.get_rchild(rules_form);
+        if (literals_ptr == 0 || node_array.get_lchild(literals_ptr) < 0) return;
+
+        macro_struct macro;
+        for (int temp_ptr = node_array.get_lchild(literals_ptr); temp_ptr != 0; temp_ptr = node_array.get_rchild(temp_ptr)) {
+            macro.literals.push_back(node_array.get_lchild(temp_ptr));
+        }
+
+        for (int temp_ptr = node_array.get_rchild(literals_ptr); temp_ptr != 0; temp_ptr = node_array.get_rchild(temp_ptr)) {
+            const int rule = node_array.get_lchild(temp_ptr);
+            if (rule <= 0 || node_array.get_rchild(rule) == 0) return;
+
+            syntax_rule_struct rule_struct;
+            rule_struct.pattern = parse_pattern(node_array.get_lchild(rule));
+            rule_struct.template_ = parse_pattern(node_array.get_lchild(node_array.get_rchild(rule)));
+            if (!rule_struct.pattern.is_list) return;
+
+            std::vector<int> variables;
+            collect_pattern_variables(macro, rule_struct.pattern, variables);
+            collect_renames(macro, rule_struct.template_, variables);
+
+            macro.rules.push_back(rule_struct);
+        }
+
+        macros[name] = macro;
+    }
+
+    // (define (f x) body ...) => (define f (lambda (x) body ...))
+    void expand_define(const int root) {
+        const int name_ptr = node_array.get_rchild(root);
+        const int signature = node_array.get_lchild(name_ptr);
+
+        const int params_ptr = alloc();
+        node_array.set_head(params_ptr, node_array.get_rchild(signature));
+        node_array.set_tail(params_ptr, node_array.get_rchild(name_ptr));
+
+        const int lambda_ptr = alloc();
+        node_array.set_head(lambda_ptr, symbol("lambda"));
+        node_array.set_tail(lambda_ptr, params_ptr);
+
+        const int value_ptr = alloc();
+        node_array.set_head(value_ptr, lambda_ptr);
+        node_array.set_tail(value_ptr, 0);
+
+        node_array.set_head(name_ptr, node_array.get_lchild(signature));
+        node_array.set_tail(name_ptr, value_ptr);
+    }
+
+    public:
+    MacroExpander(NodeArray& node_array, HashTable& hash_table, const std::function<int()>& alloc)
+        : node_array(node_array), hash_table(hash_table), alloc(alloc) {}
+
+    // 현재 macro 정의를 저장하고 restore_macros()로 되돌림
+    void save_macros() {
+        saved_macros = macros;
+    }
+
+    void restore_macros() {
+        macros = saved_macros;
+    }
+
+    // @param values: 저장된 macro 정의(저장해 둔 정의 포함)가 참조하는 값을 추가할 곳. (GC용: 문자열 literal, 숫자 symbol 등)
+    void trace(std::vector<int>& values) const {
+        for (const std::unordered_map<int, macro_struct>* table : {&macros, &saved_macros}) {
+            for (const auto& macro : *table) {
+                values.push_back(macro.first);
+                values.insert(values.end(), macro.second.literals.begin(), macro.second.literals.end());
+                for (const syntax_rule_struct& rule : macro.second.rules) {
+                    trace_pattern(rule.pattern, values);
+                    trace_pattern(rule.template_, values);
+                }
+                for (const std::pair<const int, int>& rename : macro.second.renames) {
+                    values.push_back(rename.first);
+                    values.push_back(rename.second);
+                }
+            }
+        }
+    }
+
+    bool is_macro(const int name) const {
+        return macros.count(name) != 0;
+    }
+
+    // @param root: 읽어 들인 식.
+    // @return macro와 define 축약형을 모두 전개한 식.
+    int expand(const int root) {
+        if (root <= 0 || node_array.is_object(root)) {
+            return root;
+        }
+
+        const int head = node_array.get_lchild(root);
+        int first_expanded = root; // 이 node부터 원소를 전개
+
+        if (head < 0) {
+            const std::string& keyword = hash_table.get_value(head);
+
+            if (keyword == "quote") {
+                return root;
+            } else if (keyword == HashTable::symbol_name("define-syntax")) {
+                define_syntax(root);
+                return root;
+            } else if (keyword == "define" && node_array.get_rchild(root) != 0 &&
+                       node_array.get_lchild(node_array.get_rchild(root)) > 0) {
+                expand_define(root);
+            } else if (keyword == "lambda" && node_array.get_rchild(root) != 0) {
+                // 매개변수 목록은 전개하지 않음
+                first_expanded = node_array.get_rchild(node_array.get_rchild(root));
+            }
+
+            const std::unordered_map<int, macro_struct>::const_iterator macro = macros.find(head);
+            if (macro != macros.end()) {
+                for (const syntax_rule_struct& rule : macro->second.rules) {
+                    SyntaxBindings bindings;
+                    if (match(macro->second, rule.pattern, root, bindings)) {
+                        return expand(instantiate(macro->second, rule.template_, bindings));
+                    }
+                }
+
+                // 맞는 pattern이 없으면 그대로 두고 eval()에서 오류 처리
+                return root;
+            }
+        }
+
+        for (int temp_ptr = first_expanded; temp_ptr != 0; temp_ptr = node_array.get_rchild(temp_ptr)) {
+            node_array.set_head(temp_ptr, expand(node_array.get_lchild(temp_ptr)));
+        }
+
+        return root;
+    }
+};
+
+#endif
@@ -1,40 +1,104 @@
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
 #include <string>
 
 #include "interpreter.h"
+#include "eval_server.h"
 
-int main(void) {
-    std::cout.precision(HashTable::MAX_SYMBOL_SIZE);
+int main(int argc, char* argv[]) {
+    std::cout.precision(std::numeric_limits<double>::max_digits10);
     
     Interpreter interpreter;
     std::string input = "";
 
     interpreter.init();
 
+    bool server = false;
+    std::string socket_path = "", prelude_path = "";
+    Interpreter::eval_limits_struct eval_limits;
+
+    for (int i = 1; i < argc; i++) {
+        const std::string option = argv[i];
+        if (option == "--compile") { // lambda 본문을 functor tree로 변환하여 실행
+            interpreter.set_execution_mode(Interpreter::ExecutionMode::CLOSURE_COMPILED);
+        } else if (option == "--hash-cons") { // quote된 data 중 구조가 같은 것은 node를 공유
+            interpreter.set_hash_consing_enabled(true);
+        } else if (option == "--jit") { // 자주 호출되는 숫자 lambda를 기계어로 변환하여 실행
+            if (!interpreter.set_jit_enabled(true)) {
+                std::cerr << "JIT is only available on Linux x86-64.\n";
+            }
+        } else if (option == "--server") { // stdin/stdout JSON-lines 평가 server
+            server = true;
+        } else if (option == "--socket" && i + 1 < argc) { // Unix domain socket 평가 server
+            socket_path = argv[++i];
+        } else if (option == "--trace" && i + 1 < argc) { // 종료할 때 Chrome trace_event JSON을 씀
+            interpreter.set_trace_path(argv[++i]);
+        } else if (option == "--prelude" && i + 1 < argc) { // 시작하기 전에 읽을 정의 파일
+            prelude_path = argv[++i];
+        } else if (option == "--max-steps" && i + 1 < argc) { // 명령 하나의 계산 단계 한도
+            eval_limits.max_steps = std::atoll(argv[++i]);
+        } else if (option == "--max-cells" && i + 1 < argc) { // 명령 하나가 할당하는 cell 한도
+            eval_limits.max_cells = std::atoll(argv[++i]);
+        } else if (option == "--max-depth" && i + 1 < argc) { // 함수 호출 깊이 한도
+            eval_limits.max_depth = std::atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << option << "\n";
+            return 1;
+        }
+    }
+
+    interpreter.set_eval_limits(eval_limits);
+
+    if (server || socket_path != "") {
+        EvalServer eval_server(interpreter);
+        if (prelude_path != "" && !EvalServer::load_file(interpreter, prelude_path)) {
+            std::cerr << "Failed to load prelude: " << prelude_path << "\n";
+            return 1;
+        }
+
+        if (socket_path != "") {
+            return eval_server.run_socket(socket_path) ? 0 : 1;
+        }
+        eval_server.run(std::cin, std::cout);
+        return 0;
+    }
+
+    if (prelude_path != "" && !EvalServer::load_file(interpreter, prelude_path)) {
+        std::cerr << "Failed to load prelude: " << prelude_path << "\n";
+    }
+
     do {
         std::cout << "> ";
-        do {
-            input = "";
-            std::getline(std::cin, input);
-            if (std::cin.eof()) {
-                std::cout << "\n";
-                return 0;
-            } else if (input[0] == ';') { // comment
+        try {
+            do {
                 input = "";
-            }
+                std::getline(std::cin, input);
+                if (std::cin.eof()) {
+                    std::cout << "\n";
+                    return 0;
+                } else if (input[0] == ';') { // comment
+                    input = "";
+                }
 
-            // input의 좌우 공백 제거
-            int non_blank_lpos = input.find_first_not_of(' ');
-            if (non_blank_lpos != -1) input.erase(0, non_blank_lpos);
-            int non_blank_rpos = input.find_last_not_of(' ');
-            if (non_blank_rpos != input.size() - 1) input.erase(non_blank_rpos + 1);
+                // input의 좌우 공백 제거
+                int non_blank_lpos = input.find_first_not_of(' ');
+                if (non_blank_lpos != -1) input.erase(0, non_blank_lpos);
+                int non_blank_rpos = input.find_last_not_of(' ');
+                if (non_blank_rpos != input.size() - 1) input.erase(non_blank_rpos + 1);
 
-        } while (input == "" || !interpreter.read(input));
+            } while (input == "" || !interpreter.read(input));
 
-        // interpreter.print();
+            // interpreter.print();
 
-        interpreter.eval();
-        // interpreter.print();
+            interpreter.eval();
+            // interpreter.print();
+        } catch (const std::length_error& e) {
+            // 읽는 도중 node array, hash table이 가득 차도 REPL은 계속 실행
+            std::cerr << e.what() << "\n";
+            interpreter.reset_reader();
+        }
         std::cout << "\n";
     } while (true);
 
@@ -0,0 +1,128 @@
+#ifndef MERGE_SORT_H
+#define MERGE_SORT_H
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+// -pthread로 compile하면 (_REENTRANT) 큰 입력을 여러 thread로 나누어 정렬
+#if defined(_REENTRANT)
+#include <thread>
+#define SCHEME_PARALLEL_SORT_AVAILABLE 1
+#else
+#define SCHEME_PARALLEL_SORT_AVAILABLE 0
+#endif
+
+/* 안정 merge sort
+ *  - sort_keys(): 숫자 key로 비교하는 정렬. (<, > 같은 기본 비교 함수)
+ *    interpreter 상태를 건드리지 않으므로 PARALLEL_THRESHOLD 이상이면 구간을 thread마다 정렬한 뒤 짝지어 merge한다.
+ *  - sort_values(): 사용자 함수로 비교하는 정렬. 비교 도중 오류가 나면 멈추고 false를 반환한다.
+ * 두 정렬 모두 비교 결과가 같은 원소는 입력 순서를 유지한다.
+ */
+class MergeSort {
+    public:
+    typedef std::pair<double, int> key_struct; // (비교할 숫자, 원래 값)
+
+    static const size_t PARALLEL_THRESHOLD = 1 << 15;
+    static const unsigned MAX_THREADS = 8;
+
+    private:
+    struct key_less {
+        bool descending;
+        bool operator()(const key_struct& lhs, const key_struct& rhs) const {
+            return descending ? (lhs.first > rhs.first) : (lhs.first < rhs.first);
+        }
+    };
+
+#if SCHEME_PARALLEL_SORT_AVAILABLE
+    // @param bounds: 정렬된 구간의 경계. (bounds[i]부터 bounds[i + 1] 전까지)
+    static void merge_runs(std::vector<key_struct>& keys, std::vector<size_t> bounds, const key_less& less) {
+        // 이웃한 구간을 짝지어 동시에 merge하고, 구간이 하나가 될 때까지 반복
+        while (bounds.size() > 2) {
+            std::vector<std::thread> threads;
+            std::vector<size_t> merged_bounds;
+            size_t i = 0;
+            for (; i + 2 < bounds.size(); i += 2) {
+                const size_t first = bounds[i], middle = bounds[i + 1], last = bounds[i + 2];
+                threads.push_back(std::thread([&keys, first, middle, last, less]() {
+                    std::inplace_merge(keys.begin() + first, keys.begin() + middle, keys.begin() + last, less);
+                }));
+                merged_bounds.push_back(first);
+            }
+            for (; i < bounds.size(); i++) {
+                merged_bounds.push_back(bounds[i]);
+            }
+
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            bounds.swap(merged_bounds);
+        }
+    }
+#endif
+
+    public:
+    // @param descending: 큰 key가 앞에 오도록 정렬할지의 여부.
+    static void sort_keys(std::vector<key_struct>& keys, const bool descending) {
+        const key_less less = {descending};
+
+#if SCHEME_PARALLEL_SORT_AVAILABLE
+        unsigned thread_count = std::thread::hardware_concurrency();
+        if (thread_count > MAX_THREADS) {
+            thread_count = MAX_THREADS;
+        }
+        if (keys.size() >= PARALLEL_THRESHOLD && thread_count > 1) {
+            std::vector<size_t> bounds;
+            for (unsigned i = 0; i <= thread_count; i++) {
+                bounds.push_back(keys.size() * i / thread_count);
+            }
+
+            std::vector<std::thread> threads;
+            for (unsigned i = 0; i < thread_count; i++) {
+                const size_t first = bounds[i], last = bounds[i + 1];
+                threads.push_back(std::thread([&keys, first, last, less]() {
+                    std::stable_sort(keys.begin() + first, keys.begin() + last, less);
+                }));
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+
+            merge_runs(keys, bounds, less);
+            return;
+        }
+#endif
+
+        std::stable_sort(keys.begin(), keys.end(), less);
+    }
+
+    // @param less: (lhs, rhs, result)로 호출해 lhs가 rhs보다 앞인지를 result에 저장. 오류가 나면 false를 반환.
+    // @return 오류 없이 정렬했는지의 여부.
+    template <typename Less>
+    static bool sort_values(std::vector<int>& values, Less less) {
+        std::vector<int> buffer(values.size());
+
+        // 길이 width인 정렬된 구간을 짝지어 merge (bottom-up)
+        for (size_t width = 1; width < values.size(); width *= 2) {
+            for (size_t first = 0; first < values.size(); first += 2 * width) {
+                const size_t middle = std::min(first + width, values.size());
+                const size_t last = std::min(first + 2 * width, values.size());
+
+                size_t left = first, right = middle, out = first;
+                while (left < middle && right < last) {
+                    // 오른쪽이 더 작을 때만 먼저 가져와야 안정 정렬
+                    bool is_right_less = false;
+                    if (!less(values[right], values[left], is_right_less)) return false;
+                    buffer[out++] = is_right_less ? values[right++] : values[left++];
+                }
+                while (left < middle) buffer[out++] = values[left++];
+                while (right < last) buffer[out++] = values[right++];
+            }
+            values.swap(buffer);
+        }
+
+        return true;
+    }
+};
+
+#endif
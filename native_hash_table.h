@@ -0,0 +1,255 @@
+#ifndef NATIVE_HASH_TABLE_H
+#define NATIVE_HASH_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "heap_object.h"
+
+/* scheme 값(int)을 key로 하는 open addressing hash table
+ * control byte 16개를 group 하나로 묶어 group 단위로 탐색한다. (Swiss table 방식)
+ *  - control byte: EMPTY, DELETED, 사용 중인 slot이면 hash의 하위 7 bit
+ *  - SSE2를 사용할 수 있으면 group의 control byte 16개를 한 번에 비교하고, 아니면 하나씩 비교
+ *  - key와 value는 slot 배열에 나란히 저장되어 탐색 중에 따라갈 포인터가 없음
+ * key 비교는 eq?(값 자체) 또는 equal?(interpreter가 넘겨준 구조 비교 함수)
+ */
+class NativeHashTable: public HeapObject {
+    public:
+    enum class KeyEquality { EQ, EQUAL };
+
+    typedef std::function<size_t(int)> KeyHash;
+    typedef std::function<bool(int, int)> KeyEqual;
+
+    private:
+    static const int GROUP_SIZE = 16;
+    enum : int8_t { EMPTY = -128, DELETED = -2 }; // control byte
+
+    struct slot_struct {
+        int key = 0;
+        int value = 0;
+    };
+
+    KeyEquality key_equality;
+    KeyHash key_hash;   // KeyEquality::EQUAL 전용
+    KeyEqual key_equal; // KeyEquality::EQUAL 전용
+
+    std::vector<int8_t> control;
+    std::vector<slot_struct> slots;
+    size_t group_count = 0; // 2의 거듭제곱
+    size_t item_count = 0;
+    size_t growth_left = 0; // 다시 할당하기 전까지 EMPTY slot에 더 넣을 수 있는 개수
+
+    static size_t mix(size_t hash) {
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return hash;
+    }
+
+    size_t hash_of(const int key) const {
+        if (key_equality == KeyEquality::EQ) {
+            return mix(static_cast<size_t>(static_cast<unsigned int>(key)));
+        }
+
+        return mix(key_hash(key));
+    }
+
+    bool is_same_key(const int key1, const int key2) const {
+        if (key1 == key2) {
+            return true;
+        }
+
+        return key_equality == KeyEquality::EQUAL && key_equal(key1, key2);
+    }
+
+    // @return group에서 control byte가 value인 위치의 bit mask.
+    uint32_t match_byte(const size_t group, const int8_t value) const {
+        const int8_t* group_control = &control[group * GROUP_SIZE];
+#if defined(__SSE2__)
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group_control));
+        return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(value))));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group_control[i] == value) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    // @return group에서 EMPTY 또는 DELETED인 위치의 bit mask. (둘 다 최상위 bit가 1)
+    uint32_t match_free(const size_t group) const {
+        const int8_t* group_control = &control[group * GROUP_SIZE];
+#if defined(__SSE2__)
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(group_control));
+        return static_cast<uint32_t>(_mm_movemask_epi8(bytes));
+#else
+        uint32_t mask = 0;
+        for (int i = 0; i < GROUP_SIZE; i++) {
+            if (group_control[i] < 0) mask |= 1u << i;
+        }
+        return mask;
+#endif
+    }
+
+    static int lowest_bit(const uint32_t mask) {
+        return __builtin_ctz(mask);
+    }
+
+    // @return key가 있는 slot의 index. 없으면 -1.
+    long find_slot(const int key, const size_t hash) const {
+        if (group_count == 0) {
+            return -1;
+        }
+
+        const int8_t h2 = static_cast<int8_t>(hash & 0x7f);
+        size_t group = (hash >> 7) & (group_count - 1);
+
+        // 삼각수 간격으로 group 이동: group 개수가 2의 거듭제곱이면 모든 group을 방문
+        for (size_t step = 1; ; step++) {
+            for (uint32_t mask = match_byte(group, h2); mask != 0; mask &= mask - 1) {
+                const size_t index = group * GROUP_SIZE + lowest_bit(mask);
+                if (is_same_key(slots[index].key, key)) {
+                    return static_cast<long>(index);
+                }
+            }
+
+            if (match_byte(group, EMPTY) != 0) {
+                return -1;
+            }
+            group = (group + step) & (group_count - 1);
+        }
+    }
+
+    // @return key를 넣을 EMPTY 또는 DELETED slot의 index.
+    size_t find_free_slot(const size_t hash) const {
+        size_t group = (hash >> 7) & (group_count - 1);
+        for (size_t step = 1; ; step++) {
+            const uint32_t mask = match_free(group);
+            if (mask != 0) {
+                return group * GROUP_SIZE + lowest_bit(mask);
+            }
+            group = (group + step) & (group_count - 1);
+        }
+    }
+
+    void rehash(const size_t new_group_count) {
+        std::vector<int8_t> old_control;
+        std::vector<slot_struct> old_slots;
+        old_control.swap(control);
+        old_slots.swap(slots);
+
+        group_count = new_group_count;
+        control.assign(group_count * GROUP_SIZE, EMPTY);
+        slots.assign(group_count * GROUP_SIZE, slot_struct());
+        growth_left = group_count * GROUP_SIZE * 7 / 8 - item_count; // 최대 load factor 7/8
+
+        for (size_t i = 0; i < old_control.size(); i++) {
+            if (old_control[i] < 0) continue;
+
+            const size_t hash = hash_of(old_slots[i].key);
+            const size_t index = find_free_slot(hash);
+            control[index] = static_cast<int8_t>(hash & 0x7f);
+            slots[index] = old_slots[i];
+        }
+    }
+
+    public:
+    NativeHashTable(const KeyEquality key_equality, const KeyHash& key_hash = KeyHash(), const KeyEqual& key_equal = KeyEqual())
+        : key_equality(key_equality), key_hash(key_hash), key_equal(key_equal) {}
+
+    std::string type_name() const override {
+        return "hash-table";
+    }
+
+    void trace(std::vector<int>& values) const override {
+        for (size_t i = 0; i < control.size(); i++) {
+            if (control[i] < 0) continue;
+
+            values.push_back(slots[i].key);
+            values.push_back(slots[i].value);
+        }
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + control.capacity() * sizeof(int8_t) + slots.capacity() * sizeof(slot_struct);
+    }
+
+    size_t size() const {
+        return item_count;
+    }
+
+    // @param value: key에 대응하는 값을 저장할 곳.
+    // @return key가 있는지의 여부.
+    bool get(const int key, int& value) const {
+        const long index = find_slot(key, hash_of(key));
+        if (index < 0) {
+            return false;
+        }
+
+        value = slots[index].value;
+        return true;
+    }
+
+    void set(const int key, const int value) {
+        const size_t hash = hash_of(key);
+        const long found = find_slot(key, hash);
+        if (found >= 0) {
+            slots[found].value = value;
+            return;
+        }
+
+        if (group_count == 0) {
+            rehash(1);
+        }
+
+        size_t index = find_free_slot(hash);
+        if (control[index] == EMPTY && growth_left == 0) {
+            // 삭제된 slot이 많으면 같은 크기로 정리, 아니면 2배로 확장
+            rehash(item_count * 2 < group_count * GROUP_SIZE * 7 / 8 ? group_count : group_count * 2);
+            index = find_free_slot(hash);
+        }
+
+        if (control[index] == EMPTY) {
+            growth_left--;
+        }
+        control[index] = static_cast<int8_t>(hash & 0x7f);
+        slots[index].key = key;
+        slots[index].value = value;
+        item_count++;
+    }
+
+    // @return key가 있었는지의 여부.
+    bool remove(const int key) {
+        const long index = find_slot(key, hash_of(key));
+        if (index < 0) {
+            return false;
+        }
+
+        control[index] = DELETED;
+        slots[index] = slot_struct();
+        item_count--;
+        return true;
+    }
+
+    // @return 현재 저장된 (key, value) 목록. 순회 도중 table이 바뀌어도 안전하도록 복사본을 반환
+    std::vector<std::pair<int, int>> entries() const {
+        std::vector<std::pair<int, int>> result;
+        result.reserve(item_count);
+        for (size_t i = 0; i < control.size(); i++) {
+            if (control[i] < 0) continue;
+            result.push_back(std::make_pair(slots[i].key, slots[i].value));
+        }
+
+        return result;
+    }
+};
+
+#endif
@@ -1,7 +1,124 @@
 #ifndef NODE_ARRAY_H
 #define NODE_ARRAY_H
 
+#include <climits>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <vector>
+
+#include "heap_walker.h"
+
+// 크기 변경: -DSCHEME_NODE_ARRAY_SIZE=4096
+#ifndef SCHEME_NODE_ARRAY_SIZE
+#define SCHEME_NODE_ARRAY_SIZE 31
+#endif
+
+// 크기 변경: -DSCHEME_PARSE_ARENA_SIZE=4096
+#ifndef SCHEME_PARSE_ARENA_SIZE
+#define SCHEME_PARSE_ARENA_SIZE 1024
+#endif
+
+/* cdr-coding: -DSCHEME_CDR_CODING
+ * tail을 따로 저장하지 않고 node마다 2 bit의 cdr code만 둔다.
+ *  - CDR_NEXT: tail이 바로 다음 index (연속으로 할당된 list)
+ *  - CDR_NIL: tail이 0 (list의 마지막 원소)
+ *  - CDR_EXPLICIT: 그 외의 tail은 explicit_tails(ExplicitTails)에 따로 저장
+ * set_tail()이 code를 다시 계산하므로 tail을 바꾸면 연속된 구간이 자동으로 나뉜다.
+ */
+
+/* parse arena
+ * index NODE_ARRAY_SIZE부터의 PARSE_ARENA_SIZE개 node는 명령의 parse tree만 담는 arena로,
+ * 앞에서부터 차례로 할당하고 reset_arena()로 한 번에 비운다.
+ * free list와 GC는 arena를 보지 않으며, main heap의 node가 arena의 node를 가리키는 일은 없어야 한다.
+ */
+
+#ifdef SCHEME_CDR_CODING
+/* CDR_EXPLICIT인 node의 tail
+ * node index를 key로 하는 open addressing(linear probing) 표를 두 배열에 저장해,
+ * tail 하나를 추가할 때마다 heap에 node를 할당하지 않는다. 삭제는 뒤의 항목을 당겨 채운다. (tombstone 없음)
+ */
+class ExplicitTails {
+    private:
+    static const int EMPTY = -1;
+    static const int INITIAL_CAPACITY = 64;
+
+    std::vector<int> keys;   // node index (EMPTY: 빈 칸)
+    std::vector<int> values; // tail
+    int count = 0;
+
+    // @return index가 처음 찾아볼 칸.
+    int home(const int index) const {
+        return static_cast<int>((static_cast<uint32_t>(index) * 2654435761u) & (keys.size() - 1));
+    }
+
+    // @return index가 있는 칸, 없으면 index를 넣을 빈 칸.
+    int find(const int index) const {
+        const int mask = static_cast<int>(keys.size()) - 1;
+        int slot = home(index);
+        while (keys[slot] != EMPTY && keys[slot] != index) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void grow() {
+        std::vector<int> old_keys(keys.size() * 2, EMPTY);
+        std::vector<int> old_values(values.size() * 2, 0);
+        old_keys.swap(keys); // keys, values는 두 배 크기의 빈 표가 됨
+        old_values.swap(values);
+
+        for (size_t i = 0; i < old_keys.size(); i++) {
+            if (old_keys[i] != EMPTY) {
+                const int slot = find(old_keys[i]);
+                keys[slot] = old_keys[i];
+                values[slot] = old_values[i];
+            }
+        }
+    }
+
+    public:
+    ExplicitTails() : keys(INITIAL_CAPACITY, EMPTY), values(INITIAL_CAPACITY, 0) {}
+
+    int get(const int index) const {
+        return values[find(index)];
+    }
+
+    void set(const int index, const int tail) {
+        int slot = find(index);
+        if (keys[slot] == EMPTY) {
+            // 사용률을 1/2 이하로 유지
+            if ((count + 1) * 2 > static_cast<int>(keys.size())) {
+                grow();
+                slot = find(index);
+            }
+            keys[slot] = index;
+            count++;
+        }
+        values[slot] = tail;
+    }
+
+    void erase(const int index) {
+        const int mask = static_cast<int>(keys.size()) - 1;
+        int hole = find(index);
+        if (keys[hole] == EMPTY) {
+            return;
+        }
+
+        // hole 뒤에서 처음 칸이 hole 이전인 항목을 당겨 검색 경로가 끊기지 않게 함
+        for (int slot = (hole + 1) & mask; keys[slot] != EMPTY; slot = (slot + 1) & mask) {
+            const int distance = (slot - home(keys[slot])) & mask;
+            if (distance >= ((slot - hole) & mask)) {
+                keys[hole] = keys[slot];
+                values[hole] = values[slot];
+                hole = slot;
+            }
+        }
+        keys[hole] = EMPTY;
+        count--;
+    }
+};
+#endif
 
 int length_of_int(int i) {
     return std::to_string(i).length();
@@ -14,34 +131,110 @@ struct node_array_struct {
 
 class NodeArray {
     public:
-    static const int NODE_ARRAY_SIZE = 31;
+    static const int NODE_ARRAY_SIZE = SCHEME_NODE_ARRAY_SIZE;
+    static const int PARSE_ARENA_SIZE = SCHEME_PARSE_ARENA_SIZE;
+    static const int TOTAL_SIZE = NODE_ARRAY_SIZE + PARSE_ARENA_SIZE; // main heap + parse arena
+    static const int OBJECT_TAG = INT_MIN + 1; // heap object cell의 head (symbol의 hash 값과 겹치지 않음)
+
+    // @param index: heap object cell의 index.
+    // @param values: 그 object가 참조하는 값을 추가할 곳.
+    typedef std::function<void(int, std::vector<int>&)> ObjectTracer;
 
     private:
-    node_array_struct node_array[NODE_ARRAY_SIZE];
+#ifdef SCHEME_CDR_CODING
+    enum cdr_code { CDR_NEXT = 0, CDR_NIL = 1, CDR_EXPLICIT = 2 };
+
+    int heads[TOTAL_SIZE];
+    uint8_t cdr_codes[(TOTAL_SIZE + 3) / 4]; // node 4개의 code를 1 byte에 저장
+    ExplicitTails explicit_tails;
+
+    int get_cdr_code(const int index) const {
+        return (cdr_codes[index >> 2] >> ((index & 3) * 2)) & 3;
+    }
+
+    void set_cdr_code(const int index, const int code) {
+        const int shift = (index & 3) * 2;
+        cdr_codes[index >> 2] = static_cast<uint8_t>((cdr_codes[index >> 2] & ~(3 << shift)) | (code << shift));
+    }
+
+    int load_head(const int index) const {
+        return heads[index];
+    }
+
+    int load_tail(const int index) const {
+        switch (get_cdr_code(index)) {
+        case CDR_NEXT:
+            return index + 1;
+        case CDR_NIL:
+            return 0;
+        default:
+            return explicit_tails.get(index);
+        }
+    }
+
+    void store_head(const int index, const int value) {
+        heads[index] = value;
+    }
+
+    void store_tail(const int index, const int value) {
+        if (get_cdr_code(index) == CDR_EXPLICIT) {
+            explicit_tails.erase(index);
+        }
+
+        if (value == index + 1) {
+            set_cdr_code(index, CDR_NEXT);
+        } else if (value == 0) {
+            set_cdr_code(index, CDR_NIL);
+        } else {
+            set_cdr_code(index, CDR_EXPLICIT);
+            explicit_tails.set(index, value);
+        }
+    }
+#else
+    node_array_struct node_array[TOTAL_SIZE];
+
+    int load_head(const int index) const {
+        return node_array[index].head;
+    }
+
+    int load_tail(const int index) const {
+        return node_array[index].tail;
+    }
+
+    void store_head(const int index, const int value) {
+        node_array[index].head = value;
+    }
+
+    void store_tail(const int index, const int value) {
+        node_array[index].tail = value;
+    }
+#endif
+
+    bool is_preserved[NODE_ARRAY_SIZE] = {false, }; // 마지막 GC에서 보존된 node
     int parse_tree_root = 0;
     int free_list_root = 1;
     int size_parse_tree = 0;
     int size_free_list = NODE_ARRAY_SIZE - 1;
+    int arena_size = 0; // parse arena에서 사용 중인 node 수
 
     int max_head_length = 0;
     int max_tail_length = 0;
 
     public:
     NodeArray() {
-        // 값 초기화
-        node_array[0].head = 0;
-        node_array[0].tail = 0;
-        for (int i = 1; i < NODE_ARRAY_SIZE; i++) {
-            node_array[i].head = 0;
-            node_array[i].tail = i + 1;
+#ifdef SCHEME_CDR_CODING
+        for (int i = 0; i < (TOTAL_SIZE + 3) / 4; i++) {
+            cdr_codes[i] = 0;
         }
+#endif
+        free();
     }
 
     int alloc() {
         parse_tree_root = free_list_root;
         free_list_root = get_rchild(free_list_root);
 
-        node_array[parse_tree_root].tail = 0;
+        store_tail(parse_tree_root, 0);
 
         size_parse_tree++;
         size_free_list--;
@@ -53,23 +246,77 @@ class NodeArray {
         return parse_tree_root;
     }
 
-    int get_address(const node_array_struct& item) {
-        for (int i = 0; i < NODE_ARRAY_SIZE; i++) {
-            if (&(node_array[i]) == &item) {
-                return i;
-            }
+    // @param count: 할당할 node 수. (free list의 크기보다 작아야 함)
+    // @return free list 앞의 node count개를 tail로 이은 list. (마지막 tail은 0)
+    int alloc_chain(const int count) {
+        if (count <= 0) {
+            return 0;
+        }
+
+        // free list는 이미 tail로 이어져 있으므로 마지막 node의 tail만 끊음
+        const int first = free_list_root;
+        int last = first;
+        for (int i = 1; i < count; i++) {
+            last = get_rchild(last);
+        }
+        free_list_root = get_rchild(last);
+        store_tail(last, 0);
+
+        size_parse_tree += count;
+        size_free_list -= count;
+
+        if (size_free_list < 0) {
+            throw std::length_error("Size of the node array is too small: " + std::to_string(NODE_ARRAY_SIZE));
+        }
+
+        return first;
+    }
+
+    // @return parse arena의 새 node. arena가 가득 찼으면 0
+    int arena_alloc() {
+        if (arena_size >= PARSE_ARENA_SIZE) {
+            return 0;
         }
 
-        return -1;
+        const int index = NODE_ARRAY_SIZE + arena_size++;
+        store_head(index, 0);
+        store_tail(index, 0);
+        return index;
     }
 
-    const node_array_struct& operator[](const int index) const {
+    int get_arena_size() const {
+        return arena_size;
+    }
+
+    void reset_arena() {
+        arena_size = 0;
+    }
+
+    bool is_arena(const int index) const {
+        return index >= NODE_ARRAY_SIZE;
+    }
+
+    // alloc()으로 받은 node를 GC를 거치지 않고 free list에 돌려줌
+    void release(const int index) {
+        store_head(index, 0);
+        store_tail(index, free_list_root);
+        free_list_root = index;
+
+        size_parse_tree--;
+        size_free_list++;
+    }
+
+    node_array_struct operator[](const int index) const {
         chech_size(index);
-        return node_array[index];
+
+        node_array_struct node;
+        node.head = load_head(index);
+        node.tail = load_tail(index);
+        return node;
     }
 
     void set_head(const int index, const int value) {
-        node_array[index].head = value;
+        store_head(index, value);
         if (length_of_int(value) > max_head_length) {
             max_head_length = length_of_int(value);
         }
@@ -77,11 +324,11 @@ class NodeArray {
 
     int at_head(const int index) const {
         chech_size(index);
-        return node_array[index].head;
+        return load_head(index);
     }
 
     void set_tail(const int index, const int value) {
-        node_array[index].tail = value;
+        store_tail(index, value);
 
         if (length_of_int(value) > max_tail_length) {
             max_tail_length = length_of_int(value);
@@ -90,15 +337,15 @@ class NodeArray {
 
     int at_tail(const int index) const {
         chech_size(index);
-        return node_array[index].tail;
+        return load_tail(index);
     }
 
     int get_lchild(const int index) const {
-        return node_array[index].head;
+        return load_head(index);
     }
 
     int get_rchild(const int index) const {
-        return node_array[index].tail;
+        return load_tail(index);
     }
 
     int get_free_list_root() const {
@@ -121,26 +368,22 @@ class NodeArray {
         return max_tail_length;
     }
 
-    const node_array_struct* get_node_array() const {
-        return node_array;
-    }
-
     void chech_size(const int index) const {
-        if (index >= NODE_ARRAY_SIZE) {
+        if (index >= TOTAL_SIZE) {
             throw std::range_error(
                 "Size of the node array is smaller than the entered index: \
                     index(" + std::to_string(index) +
-                ") >= NODE_ARRAY_SIZE(" + std::to_string(NODE_ARRAY_SIZE) + ")");
+                ") >= TOTAL_SIZE(" + std::to_string(TOTAL_SIZE) + ")");
         }
     }
 
     void free() {
         // 값 초기화
-        node_array[0].head = 0;
-        node_array[0].tail = 0;
+        store_head(0, 0);
+        store_tail(0, 0);
         for (int i = 1; i < NODE_ARRAY_SIZE; i++) {
-            node_array[i].head = 0;
-            node_array[i].tail = i + 1;
+            store_head(i, 0);
+            store_tail(i, i + 1);
         }
 
         parse_tree_root = 0;
@@ -152,14 +395,16 @@ class NodeArray {
         max_tail_length = 0;
     }
 
-    void garbage_collection(const int roots[], const int roots_size) {
+    void garbage_collection(const std::vector<int>& roots, const ObjectTracer& trace_object) {
         size_parse_tree = 0;
         size_free_list = NODE_ARRAY_SIZE - 1;
 
-        bool is_preserved[NODE_ARRAY_SIZE] = {false, };
+        for (int i = 0; i < NODE_ARRAY_SIZE; i++) {
+            is_preserved[i] = false;
+        }
 
-        for (int i = 0; i < roots_size; i++) {
-            check_gc_ptr(is_preserved, roots[i]);
+        for (const int root : roots) {
+            check_gc_ptr(trace_object, root);
         }
 
         // GC 가능한 node 중 가장 앞의 node를 free list의 root로 함
@@ -168,7 +413,7 @@ class NodeArray {
             if (is_preserved[i]) continue;
 
             free_list_root = i;
-            node_array[free_list_root].head = 0;
+            store_head(free_list_root, 0);
             size_free_list = 1;
             break;
         }
@@ -184,27 +429,45 @@ class NodeArray {
             this_node_index = i;
             size_free_list++;
 
-            node_array[this_node_index].head = 0;
-            node_array[last_node_index].tail = this_node_index;
+            store_head(this_node_index, 0);
+            store_tail(last_node_index, this_node_index);
         }
-        node_array[this_node_index].tail = NODE_ARRAY_SIZE;
+        store_tail(this_node_index, NODE_ARRAY_SIZE);
 
         size_parse_tree = NODE_ARRAY_SIZE - size_free_list;
     }
 
-    void check_gc_ptr(bool is_preserved[], const int index) const {
-        if (is_preserved[index]) return;
-        if (index >= NODE_ARRAY_SIZE) return;
-
-        if (node_array[index].head > 0) {
-            check_gc_ptr(is_preserved, node_array[index].head);
+    void check_gc_ptr(const ObjectTracer& trace_object, const int root) {
+        std::vector<int> objects; // 참조하는 값을 아직 확인하지 않은 heap object
+        objects.push_back(root);
+
+        while (!objects.empty()) {
+            const int object_root = objects.back();
+            objects.pop_back();
+
+            HeapWalker<NodeArray>(*this).for_each_value(object_root, [&](const int index) {
+                if (index <= 0 || index >= TOTAL_SIZE) return false;
+                if (is_arena(index)) return true; // 명령의 parse tree: 표시하지 않고 따라가기만 함
+                if (is_preserved[index]) return false;
+
+                is_preserved[index] = true;
+                if (load_head(index) == OBJECT_TAG) {
+                    // heap object가 참조하는 값
+                    trace_object(index, objects);
+                    return false;
+                }
+                return true;
+            });
         }
+    }
 
-        if (node_array[index].tail > 0) {
-            check_gc_ptr(is_preserved, node_array[index].tail);
-        }
+    // @return index의 node가 마지막 GC에서 보존되었는지의 여부.
+    bool is_marked(const int index) const {
+        return is_preserved[index];
+    }
 
-        is_preserved[index] = true;
+    bool is_object(const int index) const {
+        return index > 0 && index < NODE_ARRAY_SIZE && load_head(index) == OBJECT_TAG;
     }
 };
 
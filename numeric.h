@@ -0,0 +1,223 @@
+#ifndef NUMERIC_H
+#define NUMERIC_H
+
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+/* 숫자 symbol의 변환
+ *  - parse(): 10진 숫자를 한 번 훑으며 판별과 변환을 함께 한다. (할당 없음)
+ *    유효 숫자 19자리 이하, 10의 지수 22 이하이면 정확한 double 곱셈/나눗셈 한 번으로 변환하고 (Clinger fast path)
+ *    그 외의 드문 경우와 inf, nan, 16진수만 strtod()를 사용한다.
+ *  - format(): 다시 parse()하면 같은 double이 되는 가장 짧은 10진 표현.
+ *    정수는 자릿수를 직접 쓰고, 그 외에는 15자리부터 늘려 가며 되돌려 읽어 같은 값이 되는 첫 표현을 고른다.
+ *    (15자리 이하로 나타낼 수 있는 값은 15자리 표현이 곧 가장 짧은 표현)
+ */
+class Numeric {
+    public:
+    static const size_t MAX_FORMAT_SIZE = 32;
+
+    private:
+    static const int MAX_FAST_DIGITS = 19;   // uint64_t에 넣을 수 있는 유효 숫자
+    static const int MAX_FAST_EXPONENT = 22; // double로 정확히 나타내는 10의 거듭제곱
+    static const long long MAX_INTEGER = 1000000000000000LL; // 이보다 작은 정수는 자릿수를 직접 씀 (1e15)
+
+    static double power_of_ten(const int exponent) {
+        static const double powers[MAX_FAST_EXPONENT + 1] = {
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+            1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        return powers[exponent];
+    }
+
+    static bool is_digit(const char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // inf, nan, 16진수처럼 strtod()만 읽을 수 있는 형태
+    static bool parse_special(const char* text, const size_t size, double& value) {
+        const char* body = (*text == '+' || *text == '-') ? text + 1 : text;
+        const bool is_hex = body[0] == '0' && (body[1] == 'x' || body[1] == 'X');
+        if (!is_hex && *body != 'i' && *body != 'I' && *body != 'n' && *body != 'N') {
+            return false;
+        }
+
+        char* end = nullptr;
+        value = std::strtod(text, &end);
+        return end == text + size;
+    }
+
+    // @param exponent: e 뒤의 지수를 저장한 곳. (넘치지 않도록 큰 값은 자름)
+    // @return text의 나머지가 모두 지수인지의 여부.
+    static bool parse_exponent(const char* text, const char* end, int& exponent) {
+        bool negative = false;
+        if (text < end && (*text == '+' || *text == '-')) {
+            negative = *text == '-';
+            text++;
+        }
+        if (text == end) {
+            return false;
+        }
+
+        exponent = 0;
+        for (; text < end; text++) {
+            if (!is_digit(*text)) {
+                return false;
+            }
+            if (exponent < 100000) {
+                exponent = exponent * 10 + (*text - '0');
+            }
+        }
+        if (negative) {
+            exponent = -exponent;
+        }
+        return true;
+    }
+
+    // 1e+20 -> 1e20, 1e-05 -> 1e-5
+    static size_t trim_exponent(char* buffer, size_t length) {
+        char* exponent = static_cast<char*>(std::memchr(buffer, 'e', length));
+        if (exponent == nullptr) {
+            return length;
+        }
+
+        char* out = exponent + 1;
+        const char* in = exponent + 1;
+        if (*in == '-') {
+            *out++ = *in++;
+        } else if (*in == '+') {
+            in++;
+        }
+        while (*in == '0' && in[1] != '\0') {
+            in++;
+        }
+        while (*in != '\0') {
+            *out++ = *in++;
+        }
+        *out = '\0';
+        return static_cast<size_t>(out - buffer);
+    }
+
+    public:
+    // @param text: 판별할 token.
+    // @param value: text가 숫자이면 그 값을 저장할 곳.
+    // @return text 전체가 숫자인지의 여부.
+    static bool parse(const std::string& text, double& value) {
+        const size_t size = text.size();
+        if (size == 0) {
+            return false;
+        }
+
+        const char* p = text.c_str();
+        const char* end = p + size;
+        bool negative = false;
+        if (*p == '+' || *p == '-') {
+            negative = *p == '-';
+            p++;
+        }
+
+        std::uint64_t mantissa = 0;
+        int significant = 0, exponent = 0;
+        bool has_digit = false, is_exact = true;
+
+        for (; p < end && is_digit(*p); p++) {
+            has_digit = true;
+            if (significant < MAX_FAST_DIGITS) {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                if (mantissa != 0) significant++;
+            } else {
+                is_exact = false;
+            }
+        }
+        if (p < end && *p == '.') {
+            for (p++; p < end && is_digit(*p); p++) {
+                has_digit = true;
+                if (significant < MAX_FAST_DIGITS) {
+                    mantissa = mantissa * 10 + static_cast<std::uint64_t>(*p - '0');
+                    if (mantissa != 0) significant++;
+                    exponent--;
+                } else {
+                    is_exact = false;
+                }
+            }
+        }
+        if (!has_digit) {
+            return parse_special(text.c_str(), size, value);
+        }
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            int written_exponent = 0;
+            if (!parse_exponent(p + 1, end, written_exponent)) {
+                return false;
+            }
+            exponent += written_exponent;
+        } else if (p != end) {
+            return parse_special(text.c_str(), size, value);
+        }
+
+        if (mantissa == 0) {
+            value = negative ? -0.0 : 0.0;
+        } else if (is_exact && mantissa <= (static_cast<std::uint64_t>(1) << 53) &&
+                   exponent >= -MAX_FAST_EXPONENT && exponent <= MAX_FAST_EXPONENT) {
+            const double digits = static_cast<double>(mantissa);
+            value = (exponent < 0) ? digits / power_of_ten(-exponent) : digits * power_of_ten(exponent);
+            if (negative) value = -value;
+        } else {
+            value = std::strtod(text.c_str(), nullptr);
+        }
+        return true;
+    }
+
+    // @param buffer: MAX_FORMAT_SIZE 이상의 공간.
+    // @return buffer에 쓴 길이. (끝에 '\0'도 씀)
+    static size_t format(const double value, char* buffer) {
+        if (std::isnan(value)) {
+            std::strcpy(buffer, std::signbit(value) ? "-nan" : "nan");
+            return std::strlen(buffer);
+        }
+        if (std::isinf(value)) {
+            std::strcpy(buffer, (value < 0) ? "-inf" : "inf");
+            return std::strlen(buffer);
+        }
+
+        if (value == std::floor(value) && std::fabs(value) < MAX_INTEGER) {
+            // 정수: 뒤에서부터 자릿수를 씀
+            char digits[MAX_FORMAT_SIZE];
+            long long integer = static_cast<long long>(std::fabs(value));
+            size_t count = 0;
+            do {
+                digits[count++] = static_cast<char>('0' + integer % 10);
+                integer /= 10;
+            } while (integer != 0);
+
+            size_t length = 0;
+            if (std::signbit(value)) { // -0 포함
+                buffer[length++] = '-';
+            }
+            while (count > 0) {
+                buffer[length++] = digits[--count];
+            }
+            buffer[length] = '\0';
+            return length;
+        }
+
+        for (int precision = 15; ; precision++) {
+            const int length = std::snprintf(buffer, MAX_FORMAT_SIZE, "%.*g", precision, value);
+            if (precision == 17 || std::strtod(buffer, nullptr) == value) {
+                return trim_exponent(buffer, static_cast<size_t>(length));
+            }
+        }
+    }
+
+    // @return value의 가장 짧은 10진 표현.
+    static std::string format(const double value) {
+        char buffer[MAX_FORMAT_SIZE];
+        const size_t length = format(value, buffer);
+        return std::string(buffer, length);
+    }
+};
+
+#endif
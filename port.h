@@ -0,0 +1,272 @@
+#ifndef PORT_H
+#define PORT_H
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "heap_object.h"
+
+/* file port
+ * C library의 buffer 대신 port마다 BUFFER_SIZE 크기의 buffer를 두고 큰 단위로 읽고 쓴다.
+ * 입력 port는 buffer 하나만 다시 채워 가며 읽으므로 file 크기와 관계없이 memory 사용량이 일정하다.
+ * port가 GC로 해제되거나 interpreter가 끝나면 남은 출력을 쓰고 file을 닫는다.
+ */
+class InputPort: public HeapObject {
+    public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    private:
+    std::FILE* file = nullptr;
+    std::vector<char> buffer;
+    size_t begin = 0; // 아직 읽지 않은 첫 위치
+    size_t end = 0;
+
+    // @return 읽을 내용이 남아 있는지의 여부.
+    bool fill() {
+        if (begin < end) {
+            return true;
+        }
+        if (file == nullptr) {
+            return false;
+        }
+
+        begin = 0;
+        end = std::fread(buffer.data(), 1, buffer.size(), file);
+        return end > 0;
+    }
+
+    public:
+    explicit InputPort(std::FILE* file) : file(file), buffer(BUFFER_SIZE) {
+        std::setvbuf(file, nullptr, _IONBF, 0);
+    }
+
+    ~InputPort() {
+        close();
+    }
+
+    // @return 연 port. 열 수 없으면 nullptr.
+    static InputPort* open(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "rb");
+        return (file != nullptr) ? new InputPort(file) : nullptr;
+    }
+
+    std::string type_name() const override {
+        return "input-port";
+    }
+
+    void trace(std::vector<int>&) const override {}
+
+    size_t heap_size() const override {
+        return sizeof(*this) + buffer.capacity();
+    }
+
+    bool is_open() const {
+        return file != nullptr;
+    }
+
+    void close() {
+        if (file != nullptr) {
+            std::fclose(file);
+            file = nullptr;
+        }
+        begin = end = 0;
+    }
+
+    // @return 다음 문자. file의 끝이면 EOF.
+    int read_char() {
+        if (!fill()) {
+            return EOF;
+        }
+
+        return static_cast<unsigned char>(buffer[begin++]);
+    }
+
+    // @return 다음 문자. (읽은 위치는 그대로) file의 끝이면 EOF.
+    int peek_char() {
+        if (!fill()) {
+            return EOF;
+        }
+
+        return static_cast<unsigned char>(buffer[begin]);
+    }
+
+    // @param line: 줄바꿈 문자를 제외한 한 줄을 저장할 곳. (\r\n의 \r도 제외)
+    // @return 읽은 줄이 있는지의 여부. file의 끝이면 false.
+    bool read_line(std::string& line) {
+        line = "";
+        if (!fill()) {
+            return false;
+        }
+
+        while (fill()) {
+            const char* start = buffer.data() + begin;
+            const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+            if (newline != nullptr) {
+                line.append(start, newline - start);
+                begin += (newline - start) + 1;
+                break;
+            }
+
+            line.append(start, end - begin);
+            begin = end;
+        }
+
+        if (!line.empty() && line[line.size() - 1] == '\r') {
+            line.erase(line.size() - 1);
+        }
+        return true;
+    }
+
+    // datum 하나의 원문을 읽음: symbol, 숫자, "문자열", 괄호가 맞는 list, 'datum
+    // @param text: 읽은 원문을 저장할 곳.
+    // @return 읽은 datum이 있는지의 여부. file의 끝이면 false.
+    bool read_datum(std::string& text) {
+        text = "";
+
+        // 공백과 ';' 주석 건너뛰기
+        int c = 0;
+        while ((c = peek_char()) != EOF) {
+            if (c == ';') {
+                while ((c = read_char()) != EOF && c != '\n') {}
+            } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                read_char();
+            } else {
+                break;
+            }
+        }
+        if (c == EOF) {
+            return false;
+        }
+
+        if (c == '\'') {
+            text += static_cast<char>(read_char());
+            std::string quoted = "";
+            read_datum(quoted);
+            text += quoted;
+            return true;
+        }
+
+        int depth = 0;
+        bool in_string = false, escaped = false;
+        while ((c = peek_char()) != EOF) {
+            if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                } else if (c == '\\') {
+                    escaped = true;
+                } else if (c == '"') {
+                    in_string = false;
+                }
+            } else if (c == '"') {
+                in_string = true;
+            } else if (c == '(') {
+                if (depth == 0 && !text.empty()) break; // symbol 바로 뒤의 list
+                depth++;
+            } else if (c == ')') {
+                if (depth == 0) break; // 짝이 없는 닫는 괄호
+                depth--;
+            } else if (depth == 0 && (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ';')) {
+                break; // symbol의 끝
+            } else if (c == ';') {
+                // list 안의 주석
+                while ((c = read_char()) != EOF && c != '\n') {}
+                text += ' ';
+                continue;
+            }
+
+            text += static_cast<char>(read_char());
+            if (!in_string && depth == 0 && (c == ')' || c == '"')) {
+                break; // list, 문자열의 끝
+            }
+        }
+
+        return true;
+    }
+};
+
+class OutputPort: public HeapObject {
+    public:
+    static const size_t BUFFER_SIZE = 1 << 20;
+
+    private:
+    std::FILE* file = nullptr;
+    std::ostream* stream = nullptr; // console port: buffer 없이 stream에 바로 씀
+    std::string buffer;
+
+    public:
+    explicit OutputPort(std::FILE* file) : file(file) {
+        std::setvbuf(file, nullptr, _IONBF, 0);
+        buffer.reserve(BUFFER_SIZE);
+    }
+
+    explicit OutputPort(std::ostream& stream) : stream(&stream) {}
+
+    ~OutputPort() {
+        close();
+    }
+
+    // @return 연 port. 열 수 없으면 nullptr.
+    static OutputPort* open(const std::string& path) {
+        std::FILE* file = std::fopen(path.c_str(), "wb");
+        return (file != nullptr) ? new OutputPort(file) : nullptr;
+    }
+
+    std::string type_name() const override {
+        return "output-port";
+    }
+
+    void trace(std::vector<int>&) const override {}
+
+    size_t heap_size() const override {
+        return sizeof(*this) + buffer.capacity();
+    }
+
+    bool is_open() const {
+        return file != nullptr || stream != nullptr;
+    }
+
+    void set_stream(std::ostream& new_stream) {
+        stream = &new_stream;
+    }
+
+    void write(const std::string& text) {
+        if (stream != nullptr) {
+            *stream << text;
+            return;
+        }
+        if (file == nullptr) {
+            return;
+        }
+
+        if (buffer.size() + text.size() > BUFFER_SIZE) {
+            flush();
+        }
+        if (text.size() >= BUFFER_SIZE) {
+            std::fwrite(text.data(), 1, text.size(), file);
+        } else {
+            buffer += text;
+        }
+    }
+
+    void flush() {
+        if (stream != nullptr) {
+            stream->flush();
+        } else if (file != nullptr && !buffer.empty()) {
+            std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+    }
+
+    void close() {
+        if (file != nullptr) {
+            flush();
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef PROMISE_H
+#define PROMISE_H
+
+#include <utility>
+#include <vector>
+
+#include "heap_object.h"
+
+/* 지연 계산 값 (delay, make-promise, cons-stream)
+ * 식을 저장해 두었다가 처음 force할 때 한 번만 계산하고 그 결과를 재사용한다.
+ * 이 interpreter의 변수는 호출 중에만 hash table에 묶이고 closure가 없으므로,
+ * 식이 참조하는 symbol의 현재 값도 함께 저장해 두고 force할 때 다시 묶는다.
+ * 계산이 끝나면 결과만 남기므로 식과 저장해 둔 값은 GC가 회수할 수 있다.
+ */
+class Promise: public HeapObject {
+    public:
+    typedef std::vector<std::pair<int, int>> Bindings; // (symbol의 hash 값, 값)
+
+    private:
+    int expr = 0;
+    Bindings bindings;
+    int value = 0;
+    bool forced = false;
+
+    public:
+    Promise(const int expr, const Bindings& bindings) : expr(expr), bindings(bindings) {}
+
+    // @return 이미 value로 계산된 promise.
+    static Promise* make_forced(const int value) {
+        Promise* promise = new Promise(0, Bindings());
+        promise->set_value(value);
+        return promise;
+    }
+
+    std::string type_name() const override {
+        return "promise";
+    }
+
+    void trace(std::vector<int>& values) const override {
+        if (forced) {
+            values.push_back(value);
+            return;
+        }
+
+        values.push_back(expr);
+        for (const std::pair<int, int>& binding : bindings) {
+            values.push_back(binding.first);
+            values.push_back(binding.second);
+        }
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + bindings.capacity() * sizeof(std::pair<int, int>);
+    }
+
+    bool is_forced() const {
+        return forced;
+    }
+
+    int get_value() const {
+        return value;
+    }
+
+    int get_expr() const {
+        return expr;
+    }
+
+    const Bindings& get_bindings() const {
+        return bindings;
+    }
+
+    void set_value(const int new_value) {
+        value = new_value;
+        forced = true;
+
+        expr = 0;
+        Bindings().swap(bindings);
+    }
+};
+
+#endif
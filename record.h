@@ -0,0 +1,123 @@
+#ifndef RECORD_H
+#define RECORD_H
+
+#include <string>
+#include <vector>
+
+#include "heap_object.h"
+
+/* record type (define-record-type)
+ * record 하나는 field 값을 연속된 slot 배열에 저장하는 heap object이므로
+ * cons list로 흉내 낼 때와 달리 field 개수와 관계없이 cell 하나만 사용하고, field마다 cdr을 따라가지 않는다.
+ * 생성자, 판별자, 접근자, 변경자는 RecordProcedure이며, 정의할 때 record type과 slot 번호를 미리 정해 둔다.
+ */
+class RecordType: public HeapObject {
+    private:
+    std::string name;
+    std::vector<int> fields; // field 이름 symbol의 hash 값 (slot 순서)
+
+    public:
+    RecordType(const std::string& name, const std::vector<int>& fields) : name(name), fields(fields) {}
+
+    std::string type_name() const override {
+        return "record-type";
+    }
+
+    // field 이름의 symbol (GC가 지우지 않도록)
+    void trace(std::vector<int>& values) const override {
+        values.insert(values.end(), fields.begin(), fields.end());
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + name.capacity() + fields.capacity() * sizeof(int);
+    }
+
+    std::string write_form() const override {
+        return "#<record-type " + name + ">";
+    }
+
+    const std::string& get_name() const {
+        return name;
+    }
+
+    size_t field_count() const {
+        return fields.size();
+    }
+
+    // @return field의 slot 번호. (없으면 -1)
+    int find_field(const int field) const {
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (fields[i] == field) {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+};
+
+class Record: public HeapObject {
+    private:
+    int type = 0; // RecordType의 cell
+    std::string name;
+
+    public:
+    std::vector<int> slots;
+
+    Record(const int type, const std::string& name, const size_t field_count) : type(type), name(name), slots(field_count, 0) {}
+
+    std::string type_name() const override {
+        return name;
+    }
+
+    void trace(std::vector<int>& values) const override {
+        values.push_back(type);
+        values.insert(values.end(), slots.begin(), slots.end());
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + slots.capacity() * sizeof(int);
+    }
+
+    int get_type() const {
+        return type;
+    }
+};
+
+class RecordProcedure: public HeapObject {
+    public:
+    enum class Kind { CONSTRUCTOR, PREDICATE, ACCESSOR, MODIFIER };
+
+    private:
+    Kind kind;
+    int type = 0;                  // RecordType의 cell
+    std::vector<size_t> arg_slots; // 생성자: 인자마다 채울 slot, 접근자와 변경자: 다룰 slot 하나
+
+    public:
+    RecordProcedure(const Kind kind, const int type, const std::vector<size_t>& arg_slots) : kind(kind), type(type), arg_slots(arg_slots) {}
+
+    std::string type_name() const override {
+        return "procedure";
+    }
+
+    void trace(std::vector<int>& values) const override {
+        values.push_back(type);
+    }
+
+    size_t heap_size() const override {
+        return sizeof(*this) + arg_slots.capacity() * sizeof(size_t);
+    }
+
+    Kind get_kind() const {
+        return kind;
+    }
+
+    int get_type() const {
+        return type;
+    }
+
+    const std::vector<size_t>& get_arg_slots() const {
+        return arg_slots;
+    }
+};
+
+#endif
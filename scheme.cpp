@@ -0,0 +1,110 @@
+// 내장 API (scheme.h)의 구현: 이 파일만 compile해 library로 link
+// 컴파일: g++ -c scheme.cpp -std=c++11 -O2 -DSCHEME_NODE_ARRAY_SIZE=4096 -DSCHEME_HASH_TABLE_SIZE=1009 && ar rcs libscheme.a scheme.o
+// (interpreter.h의 기본 node array, hash table 크기는 작으므로 -D로 지정)
+#include <fstream>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "scheme.h"
+#include "interpreter.h"
+
+class SchemeEngine::Impl {
+    public:
+    Interpreter interpreter;
+    std::ostream discarded{nullptr}; // buffer가 없는 stream: 쓴 내용을 버림
+
+    Impl() {
+        interpreter.init();
+        interpreter.set_message_stream(discarded);
+        interpreter.set_output_stream(discarded);
+    }
+};
+
+SchemeEngine::SchemeEngine() : impl(new Impl()) {}
+
+SchemeEngine::~SchemeEngine() {}
+
+bool SchemeEngine::load(const std::string& source, std::string& error) {
+    Interpreter& interpreter = impl->interpreter;
+    std::istringstream lines(source);
+    std::string line = "";
+
+    try {
+        while (std::getline(lines, line)) {
+            if (line.empty() || line[0] == ';' || line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            if (!interpreter.read(line + " ")) continue; // 다음 줄과 token이 붙지 않도록 공백 추가
+
+            std::string output = "";
+            if (!interpreter.eval(output)) {
+                output.erase(output.find_last_not_of(" \n") + 1);
+                error = output;
+                interpreter.reset_reader();
+                return false;
+            }
+        }
+    } catch (const std::exception& e) {
+        error = std::string("InternalError: ") + e.what();
+        interpreter.reset_reader();
+        return false;
+    }
+
+    interpreter.reset_reader();
+    return true;
+}
+
+bool SchemeEngine::load_file(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "Cannot open file: " + path;
+        return false;
+    }
+
+    std::ostringstream source;
+    source << file.rdbuf();
+    return load(source.str(), error);
+}
+
+int SchemeEngine::prepare(const std::string& expr, const std::vector<std::string>& params, std::string& error) {
+    try {
+        return impl->interpreter.prepare(expr, params, error);
+    } catch (const std::exception& e) {
+        error = std::string("InternalError: ") + e.what();
+        return -1;
+    }
+}
+
+void SchemeEngine::release(const int handle) {
+    impl->interpreter.release_prepared(handle);
+}
+
+bool SchemeEngine::eval(const int handle, const std::vector<SchemeValue>& args, SchemeValue& result, std::string& error) {
+    try {
+        return impl->interpreter.eval_prepared(handle, args, result, error);
+    } catch (const std::exception& e) {
+        error = std::string("InternalError: ") + e.what();
+        return false;
+    }
+}
+
+void SchemeEngine::set_compile_enabled(const bool enabled) {
+    impl->interpreter.set_execution_mode(enabled ? Interpreter::ExecutionMode::CLOSURE_COMPILED
+                                                 : Interpreter::ExecutionMode::TREE_WALK);
+}
+
+bool SchemeEngine::set_jit_enabled(const bool enabled) {
+    return impl->interpreter.set_jit_enabled(enabled);
+}
+
+void SchemeEngine::set_eval_limits(const long long max_steps, const long long max_cells, const int max_depth) {
+    Interpreter::eval_limits_struct limits;
+    limits.max_steps = max_steps;
+    limits.max_cells = max_cells;
+    limits.max_depth = max_depth;
+    impl->interpreter.set_eval_limits(limits);
+}
+
+void SchemeEngine::set_output_stream(std::ostream& stream) {
+    impl->interpreter.set_output_stream(stream);
+}
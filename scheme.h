@@ -0,0 +1,74 @@
+#ifndef SCHEME_H
+#define SCHEME_H
+
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "scheme_value.h"
+
+/* 내장(embedding) API
+ * host program은 이 header만 include하고 scheme.cpp를 library로 link한다. (interpreter.h는 scheme.cpp에서만 include)
+ *  빌드: g++ -c scheme.cpp -std=c++11 -O2 -DSCHEME_NODE_ARRAY_SIZE=4096 -DSCHEME_HASH_TABLE_SIZE=1009 && ar rcs libscheme.a scheme.o
+ *        g++ -o host host.cpp libscheme.a -std=c++11
+ *
+ *  SchemeEngine engine;
+ *  std::string error = "";
+ *  engine.load("(define (clamp x) (cond ((< x 0) 0) ((> x 1) 1) (else x)))", error);
+ *  const int score = engine.prepare("(clamp (* w x))", {"w", "x"}, error);
+ *  SchemeValue result;
+ *  engine.eval(score, {0.5, 3}, result, error); // result.get_number() == 1
+ *
+ * 식은 prepare()할 때 한 번만 읽고, eval()은 인자를 매개변수에 묶어 다시 계산만 한다.
+ * 계산 결과와 script의 출력(write 등)은 std::cout에 쓰지 않는다. (script의 출력: set_output_stream())
+ * engine 하나는 한 thread에서만 사용한다.
+ */
+class SchemeEngine {
+    public:
+    SchemeEngine();
+    ~SchemeEngine();
+    SchemeEngine(const SchemeEngine&) = delete;
+    SchemeEngine& operator=(const SchemeEngine&) = delete;
+
+    // @param source: 계산할 명령. (명령 하나는 여러 줄에 걸칠 수 있으며, 한 줄에는 명령을 하나만 씀. ';'로 시작하는 줄은 주석)
+    // @param error: 오류 메시지를 저장할 곳.
+    // @return 모든 명령을 오류 없이 계산했는지의 여부. (첫 오류에서 중단)
+    bool load(const std::string& source, std::string& error);
+
+    // @param path: load()와 같은 형식의 파일.
+    bool load_file(const std::string& path, std::string& error);
+
+    // @param expr: 식 하나.
+    // @param params: 계산할 때마다 값을 넘길 매개변수 이름. (eval()의 args 순서)
+    // @param error: 식을 읽을 수 없으면 그 이유를 저장할 곳.
+    // @return 준비된 식의 handle. 읽을 수 없으면 -1.
+    int prepare(const std::string& expr, const std::vector<std::string>& params, std::string& error);
+
+    // handle을 더 이상 사용하지 않음
+    void release(const int handle);
+
+    // @param args: prepare()한 params 순서의 인자 값.
+    // @param result: 계산 결과를 저장할 곳.
+    // @param error: 오류 메시지를 저장할 곳.
+    // @return 오류 없이 계산했는지의 여부.
+    bool eval(const int handle, const std::vector<SchemeValue>& args, SchemeValue& result, std::string& error);
+
+    // lambda 본문과 준비된 식을 functor tree로 한 번 변환한 뒤 재사용 (기본값: 사용 안 함, --compile)
+    void set_compile_enabled(const bool enabled);
+
+    // @return JIT를 사용할 수 있는지의 여부. (Linux x86-64 전용, --jit)
+    bool set_jit_enabled(const bool enabled);
+
+    // eval() 한 번의 한도 (0: 제한 없음, --max-steps, --max-cells, --max-depth)
+    void set_eval_limits(const long long max_steps, const long long max_cells, const int max_depth);
+
+    // @param stream: write, newline 등 script의 출력을 쓸 곳. (기본값: 버림)
+    void set_output_stream(std::ostream& stream);
+
+    private:
+    class Impl;
+    std::unique_ptr<Impl> impl;
+};
+
+#endif
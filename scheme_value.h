@@ -0,0 +1,81 @@
+#ifndef SCHEME_VALUE_H
+#define SCHEME_VALUE_H
+
+#include <string>
+
+/* 내장 API(scheme.h)가 host와 주고받는 값
+ * interpreter 안의 값(hash 값, cell index)은 GC가 지나면 의미가 바뀌므로 host에는 복사한 값만 넘긴다.
+ *  - 인자: NIL, BOOLEAN, NUMBER, STRING, SYMBOL
+ *  - 결과: 위의 type 또는 OTHER (list, procedure 등은 write 형식의 문자열)
+ */
+class SchemeValue {
+    public:
+    enum class Type { NIL, BOOLEAN, NUMBER, STRING, SYMBOL, OTHER };
+
+    private:
+    Type type = Type::NIL;
+    double number = 0.0; // NUMBER, BOOLEAN(0 또는 1)
+    std::string text;    // STRING, SYMBOL, OTHER
+
+    SchemeValue(const Type type, const double number, const std::string& text) : type(type), number(number), text(text) {}
+
+    public:
+    SchemeValue() {}
+
+    static SchemeValue make_nil() {
+        return SchemeValue();
+    }
+
+    static SchemeValue make_boolean(const bool value) {
+        return SchemeValue(Type::BOOLEAN, value ? 1.0 : 0.0, "");
+    }
+
+    static SchemeValue make_number(const double value) {
+        return SchemeValue(Type::NUMBER, value, "");
+    }
+
+    static SchemeValue make_string(const std::string& value) {
+        return SchemeValue(Type::STRING, 0.0, value);
+    }
+
+    static SchemeValue make_symbol(const std::string& name) {
+        return SchemeValue(Type::SYMBOL, 0.0, name);
+    }
+
+    // @param write_form: 출력할 때의 문자열.
+    static SchemeValue make_other(const std::string& write_form) {
+        return SchemeValue(Type::OTHER, 0.0, write_form);
+    }
+
+    // 숫자 인자는 그대로 넘길 수 있음: engine.eval(score, {0.5, 3}, result, error)
+    SchemeValue(const double value) : type(Type::NUMBER), number(value) {}
+
+    Type get_type() const {
+        return type;
+    }
+
+    bool is_nil() const {
+        return type == Type::NIL;
+    }
+
+    bool is_number() const {
+        return type == Type::NUMBER;
+    }
+
+    // @return scheme의 참/거짓. (#f만 거짓)
+    bool is_true() const {
+        return type != Type::BOOLEAN || number != 0.0;
+    }
+
+    // @return NUMBER의 값. (그 외: 0)
+    double get_number() const {
+        return (type == Type::NUMBER) ? number : 0.0;
+    }
+
+    // @return STRING, SYMBOL의 내용 또는 OTHER의 write 형식.
+    const std::string& get_text() const {
+        return text;
+    }
+};
+
+#endif
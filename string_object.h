@@ -0,0 +1,83 @@
+#ifndef STRING_OBJECT_H
+#define STRING_OBJECT_H
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "heap_object.h"
+
+/* 문자열 값
+ * symbol은 MAX_SYMBOL_SIZE에서 잘리고 소문자로 바뀌므로 file 경로, 읽어 들인 줄 등은 heap object로 저장한다.
+ *  - 읽기: "..." (\" \\ \n \t \r escape 지원)
+ *  - 출력: write 형식은 따옴표와 escape를 붙이고, display 형식은 내용 그대로
+ */
+class StringObject: public HeapObject {
+    private:
+    std::string value;
+
+    public:
+    explicit StringObject(const std::string& value) : value(value) {}
+
+    std::string type_name() const override {
+        return "string";
+    }
+
+    void trace(std::vector<int>&) const override {}
+
+    size_t heap_size() const override {
+        return sizeof(*this) + value.capacity();
+    }
+
+    std::string write_form() const override {
+        std::string quoted = "\"";
+        for (const char c : value) {
+            switch (c) {
+            case '"':  quoted += "\\\""; break;
+            case '\\': quoted += "\\\\"; break;
+            case '\n': quoted += "\\n"; break;
+            case '\t': quoted += "\\t"; break;
+            case '\r': quoted += "\\r"; break;
+            default:   quoted += c;
+            }
+        }
+
+        return quoted + "\"";
+    }
+
+    std::string display_form() const override {
+        return value;
+    }
+
+    const std::string& get() const {
+        return value;
+    }
+
+    // @param literal: 앞뒤 따옴표를 포함한 문자열 literal. (닫는 따옴표는 없을 수 있음)
+    // @return escape를 해석한 내용.
+    static std::string unescape(const std::string& literal) {
+        std::string value = "";
+        size_t end = literal.size();
+        if (end >= 2 && literal[end - 1] == '"') {
+            end--;
+        }
+
+        for (size_t i = 1; i < end; i++) {
+            char c = literal[i];
+            if (c == '\\' && i + 1 < end) {
+                c = literal[++i];
+                switch (c) {
+                case 'n': c = '\n'; break;
+                case 't': c = '\t'; break;
+                case 'r': c = '\r'; break;
+                default: break; // 따옴표, backslash
+                }
+            }
+            value += c;
+        }
+
+        return value;
+    }
+};
+
+#endif
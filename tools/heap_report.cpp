@@ -0,0 +1,411 @@
+// (heap-snapshot "file")로 쓴 snapshot에서 root마다 dominator 기준 retained size와 type별 내역을 출력
+// 컴파일: g++ -o heap_report ./tools/heap_report.cpp -std=c++11 -O2
+// 실행: ./heap_report snapshot.json [--top N]
+//
+// node v의 retained size: v를 지나야만 도달할 수 있는 (v가 dominate하는) 모든 node의 크기 합.
+// 즉 v를 가리키는 binding을 지우면 GC가 회수할 수 있는 크기이다.
+// root마다 가상의 node를 하나씩 두고 그 node의 retained size를 그 root(binding)의 크기로 보고한다.
+// 여러 root에서 함께 도달할 수 있는 node는 어느 root에도 속하지 않으므로 shared로 따로 합산한다.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* snapshot JSON을 읽는 최소한의 parser
+ * heap_snapshot.h가 쓰는 형태(배열, 정수, 문자열, 객체의 key)만 다룬다.
+ */
+class SnapshotReader {
+    private:
+    const std::string& text;
+    size_t pos = 0;
+
+    void skip_space() {
+        while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n' || text[pos] == '\r' || text[pos] == '\t')) {
+            pos++;
+        }
+    }
+
+    public:
+    explicit SnapshotReader(const std::string& text) : text(text) {}
+
+    // @return 다음 문자가 c이면 읽고 true.
+    bool accept(const char c) {
+        skip_space();
+        if (pos < text.size() && text[pos] == c) {
+            pos++;
+            return true;
+        }
+        return false;
+    }
+
+    bool expect(const char c) {
+        if (accept(c)) {
+            return true;
+        }
+        std::fprintf(stderr, "heap_report: expected '%c' at offset %zu\n", c, pos);
+        return false;
+    }
+
+    bool read_string(std::string& value) {
+        if (!expect('"')) {
+            return false;
+        }
+
+        value = "";
+        while (pos < text.size() && text[pos] != '"') {
+            char c = text[pos++];
+            if (c == '\\' && pos < text.size()) {
+                c = text[pos++];
+                if (c == 'u' && pos + 4 <= text.size()) { // 제어 문자만 \u로 씀
+                    c = static_cast<char>(std::strtol(text.substr(pos, 4).c_str(), nullptr, 16));
+                    pos += 4;
+                }
+            }
+            value += c;
+        }
+        return expect('"');
+    }
+
+    bool read_integer(long long& value) {
+        skip_space();
+        char* end = nullptr;
+        value = std::strtoll(text.c_str() + pos, &end, 10);
+        if (end == text.c_str() + pos) {
+            std::fprintf(stderr, "heap_report: expected a number at offset %zu\n", pos);
+            return false;
+        }
+        pos = static_cast<size_t>(end - text.c_str());
+        return true;
+    }
+};
+
+struct snapshot_struct {
+    std::vector<std::string> types;
+    std::vector<int> ids;
+    std::vector<int> node_types;
+    std::vector<long long> sizes;
+    std::vector<std::vector<int>> edges; // cell id
+    std::vector<std::string> root_kinds;
+    std::vector<std::string> root_names;
+    std::vector<int> root_ids;
+};
+
+bool read_snapshot(const std::string& text, snapshot_struct& snapshot) {
+    SnapshotReader reader(text);
+    if (!reader.expect('{')) return false;
+
+    do {
+        std::string key = "";
+        if (!reader.read_string(key) || !reader.expect(':')) return false;
+
+        if (key == "version") {
+            long long version = 0;
+            if (!reader.read_integer(version)) return false;
+        } else if (key == "types") {
+            if (!reader.expect('[')) return false;
+            if (!reader.accept(']')) {
+                do {
+                    std::string type = "";
+                    if (!reader.read_string(type)) return false;
+                    snapshot.types.push_back(type);
+                } while (reader.accept(','));
+                if (!reader.expect(']')) return false;
+            }
+        } else if (key == "nodes") {
+            if (!reader.expect('[')) return false;
+            if (!reader.accept(']')) {
+                do {
+                    long long id = 0, type = 0, size = 0;
+                    if (!reader.expect('[') || !reader.read_integer(id) || !reader.expect(',') ||
+                        !reader.read_integer(type) || !reader.expect(',') ||
+                        !reader.read_integer(size) || !reader.expect(',') || !reader.expect('[')) return false;
+
+                    std::vector<int> node_edges;
+                    if (!reader.accept(']')) {
+                        do {
+                            long long edge = 0;
+                            if (!reader.read_integer(edge)) return false;
+                            node_edges.push_back(static_cast<int>(edge));
+                        } while (reader.accept(','));
+                        if (!reader.expect(']')) return false;
+                    }
+                    if (!reader.expect(']')) return false;
+
+                    snapshot.ids.push_back(static_cast<int>(id));
+                    snapshot.node_types.push_back(static_cast<int>(type));
+                    snapshot.sizes.push_back(size);
+                    snapshot.edges.push_back(node_edges);
+                } while (reader.accept(','));
+                if (!reader.expect(']')) return false;
+            }
+        } else if (key == "roots") {
+            if (!reader.expect('[')) return false;
+            if (!reader.accept(']')) {
+                do {
+                    std::string kind = "", name = "";
+                    long long id = 0;
+                    if (!reader.expect('[') || !reader.read_string(kind) || !reader.expect(',') ||
+                        !reader.read_string(name) || !reader.expect(',') ||
+                        !reader.read_integer(id) || !reader.expect(']')) return false;
+
+                    snapshot.root_kinds.push_back(kind);
+                    snapshot.root_names.push_back(name);
+                    snapshot.root_ids.push_back(static_cast<int>(id));
+                } while (reader.accept(','));
+                if (!reader.expect(']')) return false;
+            }
+        } else {
+            std::fprintf(stderr, "heap_report: unknown key '%s'\n", key.c_str());
+            return false;
+        }
+    } while (reader.accept(','));
+
+    return reader.expect('}');
+}
+
+/* dominator tree (Cooper, Harvey, Kennedy의 반복 알고리즘)
+ * graph의 0번 node에서 시작해 reverse postorder로 idom이 더 바뀌지 않을 때까지 반복한다.
+ * 도달할 수 없는 node의 idom은 -1.
+ */
+class DominatorTree {
+    private:
+    const std::vector<std::vector<int>>& successors;
+    std::vector<int> order;     // reverse postorder
+    std::vector<int> order_of;  // node -> order의 index (-1: 도달할 수 없음)
+    std::vector<int> idom;
+
+    void number_nodes() {
+        const size_t count = successors.size();
+        std::vector<int> postorder;
+        std::vector<size_t> next_edge(count, 0);
+        std::vector<bool> visited(count, false);
+        std::vector<int> stack(1, 0);
+        visited[0] = true;
+
+        // 재귀 없이 DFS
+        while (!stack.empty()) {
+            const int node = stack.back();
+            if (next_edge[node] < successors[node].size()) {
+                const int next = successors[node][next_edge[node]++];
+                if (!visited[next]) {
+                    visited[next] = true;
+                    stack.push_back(next);
+                }
+            } else {
+                postorder.push_back(node);
+                stack.pop_back();
+            }
+        }
+
+        order.assign(postorder.rbegin(), postorder.rend());
+        order_of.assign(count, -1);
+        for (size_t i = 0; i < order.size(); i++) {
+            order_of[order[i]] = static_cast<int>(i);
+        }
+    }
+
+    int intersect(int lhs, int rhs) const {
+        while (lhs != rhs) {
+            while (order_of[lhs] > order_of[rhs]) lhs = idom[lhs];
+            while (order_of[rhs] > order_of[lhs]) rhs = idom[rhs];
+        }
+        return lhs;
+    }
+
+    public:
+    explicit DominatorTree(const std::vector<std::vector<int>>& successors) : successors(successors) {
+        number_nodes();
+
+        std::vector<std::vector<int>> predecessors(successors.size());
+        for (const int node : order) {
+            for (const int next : successors[node]) {
+                predecessors[next].push_back(node);
+            }
+        }
+
+        idom.assign(successors.size(), -1);
+        idom[0] = 0;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (size_t i = 1; i < order.size(); i++) {
+                const int node = order[i];
+                int new_idom = -1;
+                for (const int pred : predecessors[node]) {
+                    if (idom[pred] == -1) continue;
+                    new_idom = (new_idom == -1) ? pred : intersect(pred, new_idom);
+                }
+                if (idom[node] != new_idom) {
+                    idom[node] = new_idom;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    const std::vector<int>& get_order() const {
+        return order;
+    }
+
+    int get_idom(const int node) const {
+        return idom[node];
+    }
+};
+
+std::string format_bytes(const long long bytes) {
+    char text[32];
+    if (bytes >= (1LL << 20)) {
+        std::snprintf(text, sizeof(text), "%.1fM", bytes / 1048576.0);
+    } else if (bytes >= (1LL << 10)) {
+        std::snprintf(text, sizeof(text), "%.1fK", bytes / 1024.0);
+    } else {
+        std::snprintf(text, sizeof(text), "%lldB", bytes);
+    }
+    return text;
+}
+
+// @param by_type: type의 index -> byte.
+// @return 큰 순서로 "type size, ..." (최대 3개)
+std::string format_breakdown(const std::map<int, long long>& by_type, const std::vector<std::string>& types) {
+    std::vector<std::pair<long long, int>> sorted;
+    for (const std::pair<const int, long long>& entry : by_type) {
+        sorted.push_back(std::make_pair(entry.second, entry.first));
+    }
+    std::sort(sorted.rbegin(), sorted.rend());
+
+    std::string text = "";
+    for (size_t i = 0; i < sorted.size() && i < 3; i++) {
+        text += (i > 0 ? ", " : "") + types[sorted[i].second] + " " + format_bytes(sorted[i].first);
+    }
+    if (sorted.size() > 3) {
+        text += ", ...";
+    }
+    return text;
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = "";
+    size_t top = 20;
+    for (int i = 1; i < argc; i++) {
+        const std::string option = argv[i];
+        if (option == "--top" && i + 1 < argc) {
+            top = static_cast<size_t>(std::atol(argv[++i]));
+        } else {
+            path = option;
+        }
+    }
+    if (path == "") {
+        std::fprintf(stderr, "usage: heap_report snapshot.json [--top N]\n");
+        return 1;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "heap_report: cannot open %s\n", path.c_str());
+        return 1;
+    }
+    std::stringstream content;
+    content << file.rdbuf();
+    const std::string text = content.str();
+
+    snapshot_struct snapshot;
+    if (!read_snapshot(text, snapshot)) {
+        return 1;
+    }
+
+    // graph: 0 = 가상의 시작 node, 1..R = root, R+1.. = cell
+    const size_t root_count = snapshot.root_ids.size();
+    const size_t node_count = snapshot.ids.size();
+    const int first_cell = static_cast<int>(root_count) + 1;
+    std::unordered_map<int, int> index_of;
+    for (size_t i = 0; i < node_count; i++) {
+        index_of[snapshot.ids[i]] = first_cell + static_cast<int>(i);
+    }
+
+    std::vector<std::vector<int>> successors(first_cell + node_count);
+    for (size_t r = 0; r < root_count; r++) {
+        successors[0].push_back(static_cast<int>(r) + 1);
+        const auto found = index_of.find(snapshot.root_ids[r]);
+        if (found != index_of.end()) {
+            successors[r + 1].push_back(found->second);
+        }
+    }
+    for (size_t i = 0; i < node_count; i++) {
+        for (const int edge : snapshot.edges[i]) {
+            const auto found = index_of.find(edge);
+            if (found != index_of.end()) {
+                successors[first_cell + i].push_back(found->second);
+            }
+        }
+    }
+
+    const DominatorTree tree(successors);
+    const std::vector<int>& order = tree.get_order();
+
+    // 각 cell을 dominate하는 root (0: 여러 root가 공유)
+    std::vector<int> owner(successors.size(), 0);
+    for (const int node : order) {
+        if (node == 0) continue;
+        const int idom = tree.get_idom(node);
+        owner[node] = (node < first_cell) ? node : (idom < first_cell ? idom : owner[idom]);
+    }
+
+    // retained size: dominator tree의 아래에서부터 합산
+    std::vector<long long> retained(successors.size(), 0);
+    std::vector<long long> retained_cells(successors.size(), 0);
+    std::vector<std::map<int, long long>> by_type(root_count + 1);
+    std::map<int, long long> total_by_type;
+    long long total = 0;
+    for (size_t i = 0; i < node_count; i++) {
+        const int node = first_cell + static_cast<int>(i);
+        if (tree.get_idom(node) == -1) continue;
+        retained[node] = snapshot.sizes[i];
+        retained_cells[node] = 1;
+        by_type[owner[node]][snapshot.node_types[i]] += snapshot.sizes[i];
+        total_by_type[snapshot.node_types[i]] += snapshot.sizes[i];
+        total += snapshot.sizes[i];
+    }
+    for (size_t i = order.size(); i > 1; i--) {
+        const int node = order[i - 1];
+        const int idom = tree.get_idom(node);
+        retained[idom] += retained[node];
+        retained_cells[idom] += retained_cells[node];
+    }
+
+    long long shared = 0;
+    for (const std::pair<const int, long long>& entry : by_type[0]) {
+        shared += entry.second;
+    }
+
+    std::printf("live: %zu cells, %s\n", node_count, format_bytes(total).c_str());
+    std::printf("by type: %s\n", format_breakdown(total_by_type, snapshot.types).c_str());
+    std::printf("shared by several roots: %s", format_bytes(shared).c_str());
+    if (shared > 0) {
+        std::printf(" (%s)", format_breakdown(by_type[0], snapshot.types).c_str());
+    }
+    std::printf("\n\n");
+
+    std::vector<int> roots;
+    for (size_t r = 1; r <= root_count; r++) {
+        roots.push_back(static_cast<int>(r));
+    }
+    std::sort(roots.begin(), roots.end(), [&retained](const int lhs, const int rhs) {
+        return retained[lhs] > retained[rhs] || (retained[lhs] == retained[rhs] && lhs < rhs);
+    });
+
+    std::printf("%10s %8s  %-12s %-20s %s\n", "retained", "cells", "kind", "name", "by type");
+    for (size_t i = 0; i < roots.size() && i < top; i++) {
+        const int root = roots[i];
+        std::printf("%10s %8lld  %-12s %-20s %s\n", format_bytes(retained[root]).c_str(), retained_cells[root],
+                    snapshot.root_kinds[root - 1].c_str(), snapshot.root_names[root - 1].c_str(),
+                    format_breakdown(by_type[root], snapshot.types).c_str());
+    }
+
+    return 0;
+}
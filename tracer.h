@@ -0,0 +1,177 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+
+/* event tracer
+ * 명령 읽기, 사용자 함수 호출, GC, symbol 추가의 시작과 끝을 ring buffer에 기록하고
+ * Chrome trace_event JSON으로 출력한다. (Perfetto, chrome://tracing에서 열 수 있음)
+ * buffer가 가득 차면 가장 오래된 event부터 덮어쓴다.
+ * 기록하는 쪽은 is_enabled()를 확인한 뒤에만 호출하므로 tracing이 꺼져 있으면 분기 하나만 남는다.
+ */
+class Tracer {
+    public:
+    static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+    struct event_struct {
+        const char* category = "";
+        const char* label = nullptr; // 고정된 이름 (nullptr: symbol의 이름)
+        int symbol = 0;              // 이름을 나타내는 symbol의 hash 값
+        char phase = 'B';            // B: 시작, E: 끝, X: 시작과 길이
+        long long timestamp_ns = 0;
+        long long duration_ns = 0;
+        const char* arg_name = nullptr;
+        long long arg_value = 0;
+    };
+
+    // @param symbol: symbol의 hash 값.
+    // @return symbol의 이름.
+    typedef std::function<std::string(int)> SymbolResolver;
+
+    private:
+    bool enabled = false;
+    std::vector<event_struct> events;
+    size_t next = 0;      // 다음에 기록할 위치
+    bool wrapped = false; // 오래된 event를 덮어쓴 적이 있는지의 여부
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+    void push(const event_struct& event) {
+        events[next] = event;
+        if (++next == events.size()) {
+            next = 0;
+            wrapped = true;
+        }
+    }
+
+    public:
+    // @return JSON 문자열 literal. (HeapSnapshot도 사용)
+    static std::string quote(const std::string& text) {
+        std::string quoted = "\"";
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                quoted += escaped;
+            } else {
+                quoted += c;
+            }
+        }
+
+        return quoted + "\"";
+    }
+
+    bool is_enabled() const {
+        return enabled;
+    }
+
+    void enable(const size_t capacity = DEFAULT_CAPACITY) {
+        events.assign(capacity, event_struct());
+        next = 0;
+        wrapped = false;
+        origin = std::chrono::steady_clock::now();
+        enabled = true;
+    }
+
+    // @return tracing을 시작한 뒤의 시간. (ns)
+    long long now_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    void begin(const char* category, const char* label, const int symbol = 0) {
+        event_struct event;
+        event.category = category;
+        event.label = label;
+        event.symbol = symbol;
+        event.phase = 'B';
+        event.timestamp_ns = now_ns();
+        push(event);
+    }
+
+    void end(const char* category, const char* arg_name = nullptr, const long long arg_value = 0) {
+        event_struct event;
+        event.category = category;
+        event.phase = 'E';
+        event.timestamp_ns = now_ns();
+        event.arg_name = arg_name;
+        event.arg_value = arg_value;
+        push(event);
+    }
+
+    // @param start_ns: now_ns()로 잰 시작 시간.
+    void complete(const char* category, const char* label, const long long start_ns,
+                  const char* arg_name = nullptr, const long long arg_value = 0, const int symbol = 0) {
+        event_struct event;
+        event.category = category;
+        event.label = label;
+        event.symbol = symbol;
+        event.phase = 'X';
+        event.timestamp_ns = start_ns;
+        event.duration_ns = now_ns() - start_ns;
+        event.arg_name = arg_name;
+        event.arg_value = arg_value;
+        push(event);
+    }
+
+    // @return 기록된 event의 Chrome trace_event JSON.
+    std::string to_json(const SymbolResolver& symbol_name) const {
+        std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        const size_t count = wrapped ? events.size() : next;
+        const size_t first = wrapped ? next : 0;
+
+        int depth = 0; // 덮어써서 시작이 없어진 E event는 생략
+        bool is_first = true;
+        for (size_t i = 0; i < count; i++) {
+            const event_struct& event = events[(first + i) % events.size()];
+            if (event.phase == 'B') {
+                depth++;
+            } else if (event.phase == 'E') {
+                if (depth == 0) continue;
+                depth--;
+            }
+
+            char timestamp[64];
+            std::snprintf(timestamp, sizeof(timestamp), "%.3f", event.timestamp_ns / 1000.0);
+
+            json += is_first ? "\n" : ",\n";
+            is_first = false;
+            json += "{\"ph\":\"" + std::string(1, event.phase) + "\",\"cat\":" + quote(event.category) +
+                    ",\"ts\":" + timestamp + ",\"pid\":1,\"tid\":1";
+            if (event.phase != 'E') {
+                const std::string name = (event.label != nullptr) ? event.label : symbol_name(event.symbol);
+                json += ",\"name\":" + quote(name);
+            }
+            if (event.phase == 'X') {
+                char duration[64];
+                std::snprintf(duration, sizeof(duration), "%.3f", event.duration_ns / 1000.0);
+                json += std::string(",\"dur\":") + duration;
+            }
+            if (event.arg_name != nullptr) {
+                json += ",\"args\":{" + quote(event.arg_name) + ":" + std::to_string(event.arg_value) + "}";
+            }
+            json += "}";
+        }
+
+        return json + "\n]}\n";
+    }
+
+    // @return file에 썼는지의 여부.
+    bool dump(const std::string& path, const SymbolResolver& symbol_name) const {
+        std::ofstream file(path);
+        if (!file) {
+            return false;
+        }
+
+        file << to_json(symbol_name);
+        return static_cast<bool>(file);
+    }
+};
+
+#endif